@@ -1,6 +1,8 @@
 #pragma once
 
 #include <SFML/Graphics/Color.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -81,6 +83,50 @@ namespace Constants {
     //=========================================================================
     // World Generation
     //=========================================================================
+    // --- Terrain Streaming ---
+    // Chunk cache location under the per-user cache directory, and its size on disk.
+    inline constexpr std::string_view CHUNK_CACHE_DIRECTORY = "transity/terrain";
+    constexpr std::uint64_t CHUNK_CACHE_BUDGET_BYTES = 512ull * 1024 * 1024;
+    // Workers of the thread pool's I/O lane, which runs chunk cache reads, writes and saves.
+    constexpr unsigned int IO_LANE_THREADS = 2;
+    // Chunk loads handed to the pools at once; the rest wait, nearest to the camera first.
+    constexpr std::size_t CHUNK_MAX_IN_FLIGHT_REQUESTS = 16;
+    // Chunks are prefetched where the camera is predicted to be this far ahead, using at
+    // most this many of the in-flight slots. Motion is averaged over the smoothing time.
+    constexpr float CHUNK_PREFETCH_LOOKAHEAD_S = 0.5f;
+    constexpr std::size_t CHUNK_PREFETCH_MAX_IN_FLIGHT = 4;
+    constexpr float CHUNK_PREFETCH_SMOOTHING_S = 0.15f;
+    // Unloaded chunks, meshes included, are kept for reuse up to this many bytes.
+    constexpr std::size_t CHUNK_RETENTION_BUDGET_BYTES = 64 * 1024 * 1024;
+    // Regeneration requests are applied once none has followed for this long, so dragging
+    // a setting only rebuilds the world for its final value.
+    constexpr float WORLD_REGENERATION_DEBOUNCE_S = 0.15f;
+    // Rows per band the whole-world raster is generated in. A multiple of four, so bands
+    // never share a byte of packed terrain.
+    constexpr int WORLD_RASTER_BAND_ROWS = 32;
+    // Cells whose terrain had to be sampled from noise are remembered up to this many.
+    constexpr std::size_t TERRAIN_QUERY_CACHE_CELLS = 16384;
+    // Lattice side and pass count for the debug noise benchmarks.
+    constexpr int NOISE_BENCHMARK_CELLS = 256;
+    constexpr int NOISE_BENCHMARK_REPETITIONS = 4;
+    // Thread pool benchmark: root tasks enqueued from outside the pool, each spawning this
+    // many nested tasks, at thread counts doubling up to the maximum, and a burst of tasks
+    // whose submission alone is timed.
+    constexpr int THREAD_POOL_BENCHMARK_MAX_THREADS = 64;
+    constexpr int THREAD_POOL_BENCHMARK_ROOT_TASKS = 256;
+    constexpr int THREAD_POOL_BENCHMARK_CHILD_TASKS = 64;
+    constexpr int THREAD_POOL_BENCHMARK_SUBMITTED_TASKS = 20000;
+    constexpr int THREAD_POOL_BENCHMARK_REPETITIONS = 3;
+    // Longest side, in pixels, of the world preview shown while tuning generation settings,
+    // and the side of the square tiles it is generated in.
+    constexpr int WORLD_PREVIEW_SIZE = 256;
+    constexpr int WORLD_PREVIEW_TILE_CELLS = 32;
+    // Coarser chunk levels are used once more than this many chunks span the view.
+    constexpr float TERRAIN_LOD_MAX_CHUNKS_ACROSS = 16.0f;
+    // Drop back to a finer level only when it would span below this fraction of the max.
+    constexpr float TERRAIN_LOD_HYSTERESIS = 0.8f;
+    constexpr int TERRAIN_LOD_MAX_LEVEL = 4;
+
     // --- City Placement ---
     constexpr int INITIAL_CITY_COUNT = 4;
     constexpr int MAX_CITIES = 50;
@@ -100,6 +146,8 @@ namespace Constants {
     constexpr float SUBURB_PROXIMITY_RANGE_TOWN = 50.0f;
     constexpr float TOWN_PROXIMITY_MIN_DISTANCE = 50.0f;
     constexpr float TOWN_PROXIMITY_MAX_DISTANCE = 150.0f;
+    // Cells per tile when a suitability pass is split across the thread pool.
+    constexpr int SUITABILITY_TILE_CELLS = 64 * 1024;
 
     // --- City Finding Algorithm ---
     constexpr int FIND_BEST_CITY_LOCATION_SAMPLES = 5000;
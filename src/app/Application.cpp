@@ -12,6 +12,7 @@
 #include "systems/gameplay/LineCreationSystem.h"
 #include "ui/UI.h"
 #include "ui/UIManager.h"
+#include "world/SimdKernels.h"
 #include <SFML/Graphics/Image.hpp>
 #include <array>
 #include <chrono>
@@ -116,15 +117,20 @@ Application::Application()
             LOG_WARN("Application", "Generated icon has invalid size, skipping icon setup.");
         }
     }
+    // Chooses the numeric kernels for this CPU up front so the choice is logged once at startup.
+    SimdKernels::active();
     try {
         unsigned int numThreads = std::thread::hardware_concurrency();
-        _threadPool = std::make_unique<ThreadPool>(numThreads > 0 ? numThreads : 1);
-        LOG_DEBUG("Application", "ThreadPool created with %u threads.", numThreads);
+        _threadPool = std::make_unique<ThreadPool>(numThreads > 0 ? numThreads : 1,
+                                                   Constants::IO_LANE_THREADS);
+        LOG_DEBUG("Application", "ThreadPool created with %u threads and %u I/O threads.",
+                  numThreads, Constants::IO_LANE_THREADS);
 
         _renderer = std::make_unique<Renderer>(_colorManager, _window);
         _renderer->initialize();
 
-        _game = std::make_unique<Game>(*_renderer, *_threadPool, _eventBus, _colorManager);
+        _game = std::make_unique<Game>(*_renderer, *_threadPool, _eventBus,
+                                       _colorManager);
 
         _renderer->connectToEventBus(_eventBus);
 
@@ -141,7 +147,8 @@ Application::Application()
         _uiManager = std::make_unique<UIManager>(
             _game->getRegistry(), _eventBus, _game->getWorldGenSystem(),
             _renderer->getTerrainRenderSystem(), _game->getPerformanceMonitor(), _game->getCamera(),
-            _game->getGameState(), _colorManager, _window, _game->getCityPlacementSystem());
+            _game->getGameState(), _colorManager, _window, _game->getCityPlacementSystem(),
+            _game->getChunkManagerSystem(), *_threadPool);
 
     } catch (const std::exception &e) {
         LOG_FATAL("Application", "Failed during initialization: %s", e.what());
@@ -162,6 +169,7 @@ void Application::run() {
         _timeAccumulator += frameTime;
 
         processEvents();
+        _game->processCompletions();
 
         const auto appState = _game->getGameState().currentAppState;
 
@@ -202,8 +210,7 @@ void Application::run() {
         }
         case AppState::LOADING: {
             _ui->update(frameTime, appState);
-            if (_game->getLoadingFuture().wait_for(std::chrono::seconds(0))
-                == std::future_status::ready) {
+            if (!_game->isLoading()) {
                 _game->getGameState().currentAppState = AppState::PLAYING;
                 LOG_INFO("Application", "Loading complete, switching to PLAYING state.");
 
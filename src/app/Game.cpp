@@ -20,12 +20,14 @@
 #include "systems/app/SaveLoadSystem.h"
 #include "systems/world/ChunkManagerSystem.h"
 #include "systems/world/WorldSetupSystem.h"
+#include <algorithm>
 
 Game::Game(Renderer &renderer, ThreadPool &threadPool, EventBus &eventBus,
            ColorManager &colorManager)
     : _renderer(renderer), _eventBus(eventBus), _colorManager(colorManager),
       _entityFactory(_registry, "data/archetypes"), _worldGenerationSystem(_registry, _eventBus),
-      _pathfinder(_registry), _threadPool(threadPool) {
+      _pathfinder(_registry), _threadPool(threadPool),
+      _worldRaster(threadPool), _terrainQuery(_registry, _worldGenerationSystem, _worldRaster) {
 
     _inputHandler = std::make_unique<InputHandler>(_eventBus, _camera);
     _systemManager = std::make_unique<SystemManager>();
@@ -34,7 +36,7 @@ Game::Game(Renderer &renderer, ThreadPool &threadPool, EventBus &eventBus,
     // UI, input, and world loading systems that should always run
     _systemManager->addSystem<CameraSystem>(_camera, _renderer, _worldGenerationSystem, _eventBus);
     _systemManager->addSystem<LineCreationSystem>(_registry, _entityFactory, _colorManager,
-                                                  _gameState, _eventBus, _worldGenerationSystem);
+                                                  _gameState, _eventBus, _terrainQuery);
     _systemManager->addSystem<GameStateSystem>(_eventBus, _gameState);
     _systemManager->addSystem<SelectionSystem>(_registry, _eventBus, _gameState, _pathfinder);
     _systemManager->addSystem<DeletionSystem>(_registry, _eventBus, _gameState);
@@ -42,7 +44,8 @@ Game::Game(Renderer &renderer, ThreadPool &threadPool, EventBus &eventBus,
     _systemManager->addSystem<SharedSegmentSystem>(_registry, _eventBus);
     auto *chunkManagerSystem =
         _systemManager->addSystem<ChunkManagerSystem>(_registry, _eventBus, _worldGenerationSystem,
-                                                      _camera, _threadPool);
+                                                      _worldRaster, _camera, _threadPool);
+    _terrainQuery.setChunkSource(chunkManagerSystem);
     _systemManager->addSystem<TerrainMeshSystem>(_registry, _renderer, _worldGenerationSystem,
                                                  _eventBus);
     _systemManager->addSystem<PassengerSpawnAnimationSystem>(_registry, _entityFactory,
@@ -51,9 +54,9 @@ Game::Game(Renderer &renderer, ThreadPool &threadPool, EventBus &eventBus,
     // Simulation systems that should be paused
     _simulationSystemManager->addSystem<WorldSetupSystem>(
         _registry, _loadingState, _worldGenerationSystem, _renderer, _camera);
-    _simulationSystemManager->addSystem<CityPlacementSystem>(_loadingState, _worldGenerationSystem,
-                                                             _entityFactory, _renderer, _eventBus,
-                                                             _performanceMonitor, _threadPool);
+    _simulationSystemManager->addSystem<CityPlacementSystem>(
+        _loadingState, _worldGenerationSystem, _worldRaster, _entityFactory, _renderer, _eventBus,
+        _performanceMonitor, _threadPool);
     _simulationSystemManager->addSystem<TrainMovementSystem>(_registry);
     _simulationSystemManager->addSystem<PassengerMovementSystem>(_registry);
     _simulationSystemManager->addSystem<PassengerSpawnSystem>(_registry, _entityFactory,
@@ -67,7 +70,8 @@ Game::Game(Renderer &renderer, ThreadPool &threadPool, EventBus &eventBus,
     if (chunkManagerSystem && cityPlacementSystem && passengerSpawnSystem) {
         _systemManager->addSystem<SaveLoadSystem>(_registry, _eventBus, _worldGenerationSystem,
                                                   *chunkManagerSystem, *cityPlacementSystem,
-                                                  *passengerSpawnSystem, _gameState, _camera);
+                                                  *passengerSpawnSystem, _gameState, _camera,
+                                                  _threadPool);
     } else {
         LOG_ERROR("Game",
                   "Failed to initialize SaveLoadSystem due to missing dependencies (ChunkManager: "
@@ -88,6 +92,10 @@ void Game::updateSimulation(sf::Time dt) {
     _simulationSystemManager->update(dt);
 }
 
+ChunkManagerSystem &Game::getChunkManagerSystem() {
+    return *_systemManager->getSystem<ChunkManagerSystem>();
+}
+
 void Game::startLoading() {
     _loadingState.progress = 0.0f;
     _loadingState.message = "Initializing world systems...";
@@ -95,16 +103,34 @@ void Game::startLoading() {
     auto worldSetupSystem = _simulationSystemManager->getSystem<WorldSetupSystem>();
     auto cityPlacementSystem = _simulationSystemManager->getSystem<CityPlacementSystem>();
 
-    _loadingFuture = _threadPool.enqueue([worldSetupSystem, cityPlacementSystem]() {
-        if (worldSetupSystem) {
-            worldSetupSystem->init();
-        }
-        if (cityPlacementSystem) {
-            cityPlacementSystem->init();
+    // The loading screen waits on this, so it runs ahead of any streaming work. A failed
+    // load is logged and still ends the loading screen.
+    const std::size_t loadId = ++_startedLoad;
+    auto load = [this, ticket = _loadTasks.track(), loadId, worldSetupSystem,
+                 cityPlacementSystem]() {
+        try {
+            if (worldSetupSystem) {
+                worldSetupSystem->init();
+            }
+            if (cityPlacementSystem) {
+                cityPlacementSystem->init();
+            }
+        } catch (const std::exception &ex) {
+            LOG_ERROR("Game", "World loading failed: %s", ex.what());
+        } catch (...) {
+            LOG_ERROR("Game", "World loading failed with unknown error.");
         }
-    });
+        _completions.push([this, loadId]() { _finishedLoad = std::max(_finishedLoad, loadId); });
+    };
+    _threadPool.post(TaskPriority::Interactive, std::move(load));
+}
+
+void Game::processCompletions() {
+    _completions.drain([](Task &&completion) { completion(); });
 }
 
 Game::~Game() {
+    // A load still running uses the systems and the completion queue.
+    _loadTasks.wait();
     LOG_INFO("Game", "Game instance destroyed.");
 }
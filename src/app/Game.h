@@ -2,8 +2,11 @@
 
 #include "GameState.h"
 #include "LoadingState.h"
+#include "core/CompletionQueue.h"
 #include "core/Pathfinder.h"
 #include "core/PerformanceMonitor.h"
+#include "core/Task.h"
+#include "core/TaskTracker.h"
 #include "ecs/EntityFactory.h"
 #include "ecs/SystemManager.h"
 #include "event/EventBus.h"
@@ -11,8 +14,9 @@
 #include "render/ColorManager.h"
 #include "systems/rendering/PassengerSpawnAnimationSystem.h"
 #include "systems/world/WorldGenerationSystem.h"
+#include "world/TerrainQueryService.h"
+#include "world/WorldRaster.h"
 #include <entt/entt.hpp>
-#include <future>
 #include <memory>
 
 class Renderer;
@@ -45,11 +49,16 @@ public:
     CityPlacementSystem &getCityPlacementSystem() {
         return *_simulationSystemManager->getSystem<CityPlacementSystem>();
     }
+    ChunkManagerSystem &getChunkManagerSystem();
     PassengerSpawnAnimationSystem &getPassengerSpawnAnimationSystem() {
         return *_systemManager->getSystem<PassengerSpawnAnimationSystem>();
     }
 
-    std::future<void> &getLoadingFuture() { return _loadingFuture; }
+    // Runs, on the calling thread, what background tasks have handed back to the game.
+    // Called once a frame from the main thread.
+    void processCompletions();
+    // True from startLoading() until the world it started has been set up.
+    bool isLoading() const { return _finishedLoad != _startedLoad; }
 
 private:
     Renderer &_renderer;
@@ -65,10 +74,16 @@ private:
     PerformanceMonitor _performanceMonitor;
     Pathfinder _pathfinder;
     ThreadPool &_threadPool;
+    WorldRaster _worldRaster;
+    TerrainQueryService _terrainQuery;
 
     std::unique_ptr<SystemManager> _systemManager;
     std::unique_ptr<SystemManager> _simulationSystemManager;
     std::unique_ptr<InputHandler> _inputHandler;
 
-    std::future<void> _loadingFuture;
+    CompletionQueue<Task> _completions;
+    std::size_t _startedLoad = 0;
+    std::size_t _finishedLoad = 0;
+    // Load tasks run the game's systems; the destructor waits for them.
+    TaskTracker _loadTasks;
 };
\ No newline at end of file
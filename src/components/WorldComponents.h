@@ -3,6 +3,7 @@
 #include "world/TerrainType.h"
 #include "world/WorldData.h"
 #include <SFML/System.hpp>
+#include <memory>
 #include <vector>
 
 // Represents a single cell in the world grid.
@@ -16,16 +17,24 @@ struct ChunkLoadingTag {};
 // The position of a chunk in the world grid.
 struct ChunkPositionComponent {
     sf::Vector2i chunkGridPosition;
+    // Grid position is in units of level-N chunks; see GeneratedChunkData::lodLevel.
+    int lodLevel = 0;
 };
 
 // The terrain data for a chunk.
 struct ChunkTerrainComponent {
-    std::vector<TerrainType> cells;
+    PackedTerrainCells cells;
 };
 
-// The elevation values for a chunk, stored per cell in world units.
+// The elevation values for a chunk, quantized per cell against the max elevation.
 struct ChunkElevationComponent {
-    std::vector<float> elevations;
+    QuantizedElevations elevations;
+};
+
+// The per-layer noise a chunk was generated from, kept so parameter tweaks that only
+// affect how layers are combined can skip noise evaluation.
+struct ChunkNoiseFieldsComponent {
+    std::shared_ptr<const ChunkNoiseFields> fields;
 };
 
 // The current state of a chunk, such as whether its mesh needs rebuilding.
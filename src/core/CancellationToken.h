@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+// Lets whoever started a piece of background work tell the workers doing it to stop. Copies
+// share one flag; a token created with a parent is also cancelled when the parent is. A
+// default-constructed token is never cancelled. Safe to use from any thread.
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    static CancellationToken create(const CancellationToken &parent = {}) {
+        CancellationToken token;
+        token._state = std::make_shared<State>();
+        token._state->parent = parent._state;
+        return token;
+    }
+
+    void cancel() const {
+        if (_state) {
+            _state->cancelled.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    bool isCancelled() const {
+        for (const State *state = _state.get(); state; state = state->parent.get()) {
+            if (state->cancelled.load(std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // True when both tokens share the same flag, or neither has one.
+    bool operator==(const CancellationToken &other) const { return _state == other._state; }
+    bool operator!=(const CancellationToken &other) const { return _state != other._state; }
+
+private:
+    struct State {
+        std::atomic<bool> cancelled{false};
+        std::shared_ptr<const State> parent;
+    };
+
+    std::shared_ptr<State> _state;
+};
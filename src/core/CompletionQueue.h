@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Hands finished work from worker threads to one consumer thread, usually the main thread,
+// which drains it once a frame. Any thread may push, without locking; draining takes time
+// proportional to what has completed rather than to what is still outstanding, and yields
+// results in the order they were pushed.
+template <typename T>
+class CompletionQueue {
+public:
+    CompletionQueue() = default;
+    ~CompletionQueue() { deleteList(_newest.exchange(nullptr, std::memory_order_acquire)); }
+
+    CompletionQueue(const CompletionQueue &) = delete;
+    CompletionQueue &operator=(const CompletionQueue &) = delete;
+
+    // Any thread.
+    void push(T value) {
+        auto *node = new Node{std::move(value), _newest.load(std::memory_order_relaxed)};
+        while (!_newest.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+        }
+    }
+
+    // Consumer only. Calls `handle(T &&)` for everything pushed so far, oldest first, and
+    // returns how many there were. Values pushed while draining, even by `handle`, wait for
+    // the next drain.
+    template <typename Handler>
+    std::size_t drain(Handler &&handle) {
+        // The consumer takes the whole list at once, so pushes never race a removal.
+        Node *oldest = nullptr;
+        for (Node *node = _newest.exchange(nullptr, std::memory_order_acquire); node;) {
+            Node *next = node->next;
+            node->next = oldest;
+            oldest = node;
+            node = next;
+        }
+
+        std::size_t count = 0;
+        while (oldest) {
+            std::unique_ptr<Node> node(oldest);
+            oldest = node->next;
+            try {
+                handle(std::move(node->value));
+            } catch (...) {
+                deleteList(oldest);
+                throw;
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    // Consumer only. Drops everything pushed so far.
+    void clear() {
+        drain([](T &&) {});
+    }
+
+    // A snapshot that may be stale by the time it is read.
+    bool empty() const { return _newest.load(std::memory_order_relaxed) == nullptr; }
+
+private:
+    struct Node {
+        T value;
+        Node *next;
+    };
+
+    static void deleteList(Node *node) {
+        while (node) {
+            delete std::exchange(node, node->next);
+        }
+    }
+
+    std::atomic<Node *> _newest{nullptr};
+};
@@ -0,0 +1,112 @@
+#include "CpuFeatures.h"
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#define TRANSITY_CPUID_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define TRANSITY_CPUID_X86 1
+#endif
+
+namespace {
+
+#ifdef TRANSITY_CPUID_X86
+
+struct CpuidRegisters {
+    std::uint32_t eax = 0;
+    std::uint32_t ebx = 0;
+    std::uint32_t ecx = 0;
+    std::uint32_t edx = 0;
+};
+
+CpuidRegisters cpuid(std::uint32_t leaf, std::uint32_t subleaf) {
+    CpuidRegisters regs;
+#ifdef _MSC_VER
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    regs = {static_cast<std::uint32_t>(values[0]), static_cast<std::uint32_t>(values[1]),
+            static_cast<std::uint32_t>(values[2]), static_cast<std::uint32_t>(values[3])};
+#else
+    __cpuid_count(leaf, subleaf, regs.eax, regs.ebx, regs.ecx, regs.edx);
+#endif
+    return regs;
+}
+
+// The register state the OS saves on context switches (XCR0). Only valid with OSXSAVE.
+std::uint64_t enabledXsaveState() {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    std::uint32_t low = 0;
+    std::uint32_t high = 0;
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<std::uint64_t>(high) << 32) | low;
+#endif
+}
+
+bool hasBit(std::uint32_t value, int bit) {
+    return (value >> bit) & 1u;
+}
+
+CpuFeatures detect() {
+    // XCR0 bits: SSE and AVX register halves; the AVX-512 opmask and upper registers.
+    constexpr std::uint64_t AVX_STATE = 0x6;
+    constexpr std::uint64_t AVX512_STATE = 0xE0;
+
+    CpuFeatures features;
+    const std::uint32_t maxLeaf = cpuid(0, 0).eax;
+    if (maxLeaf < 1) {
+        return features;
+    }
+    const CpuidRegisters leaf1 = cpuid(1, 0);
+    features.sse2 = hasBit(leaf1.edx, 26);
+    features.sse41 = hasBit(leaf1.ecx, 19);
+
+    const bool osSavesAvx =
+        hasBit(leaf1.ecx, 27) && (enabledXsaveState() & AVX_STATE) == AVX_STATE;
+    if (!osSavesAvx) {
+        return features;
+    }
+    features.avx = hasBit(leaf1.ecx, 28);
+    features.fma = features.avx && hasBit(leaf1.ecx, 12);
+    if (maxLeaf >= 7) {
+        const CpuidRegisters leaf7 = cpuid(7, 0);
+        features.avx2 = features.avx && hasBit(leaf7.ebx, 5);
+        features.avx512f = features.avx && hasBit(leaf7.ebx, 16)
+                           && (enabledXsaveState() & AVX512_STATE) == AVX512_STATE;
+    }
+    return features;
+}
+
+#else
+
+CpuFeatures detect() {
+    return {};
+}
+
+#endif
+
+}  // namespace
+
+std::string CpuFeatures::describe() const {
+    std::string names;
+    auto add = [&names](bool supported, const char *name) {
+        if (supported) {
+            names += names.empty() ? name : std::string(" ") + name;
+        }
+    };
+    add(sse2, "SSE2");
+    add(sse41, "SSE4.1");
+    add(avx, "AVX");
+    add(avx2, "AVX2");
+    add(fma, "FMA");
+    add(avx512f, "AVX-512F");
+    return names.empty() ? "none" : names;
+}
+
+const CpuFeatures &cpuFeatures() {
+    static const CpuFeatures features = detect();
+    return features;
+}
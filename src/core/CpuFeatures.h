@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+// Instruction set extensions the CPU and operating system both support. A set counts only
+// once the OS saves its registers across context switches, so AVX is off under an OS that
+// has not enabled it even when cpuid advertises it. All false on non-x86 targets.
+struct CpuFeatures {
+    bool sse2 = false;
+    bool sse41 = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+
+    // Space-separated names of the supported extensions, e.g. "SSE2 SSE4.1 AVX AVX2".
+    std::string describe() const;
+};
+
+// Detected once on first call; safe to call from any thread.
+const CpuFeatures &cpuFeatures();
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// 64-bit FNV-1a over the raw bytes of plain values. Used to fingerprint generation
+// settings; not suitable for anything adversarial.
+class Fnv1a {
+public:
+    template <typename T> void add(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only hash plain values.");
+        const auto *bytes = reinterpret_cast<const unsigned char *>(&value);
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            _hash ^= bytes[i];
+            _hash *= 1099511628211ULL;
+        }
+    }
+
+    std::uint64_t value() const noexcept { return _hash; }
+
+private:
+    std::uint64_t _hash = 14695981039346656037ULL;
+};
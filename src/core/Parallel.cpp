@@ -0,0 +1,72 @@
+#include "Parallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace Parallel {
+
+namespace {
+
+// Shared with the helper tasks, which may start only after the loop has returned. They
+// touch `runTile` only after claiming a tile, and the caller waits for every claimed tile.
+struct TileState {
+    const std::function<void(int)> *runTile = nullptr;
+    int tileCount = 0;
+    std::atomic<int> nextTile{0};
+    std::atomic<int> finishedTiles{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+};
+
+void runTiles(TileState &state) {
+    for (int tile = state.nextTile.fetch_add(1, std::memory_order_relaxed);
+         tile < state.tileCount; tile = state.nextTile.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+            (*state.runTile)(tile);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (!state.error) {
+                state.error = std::current_exception();
+            }
+        }
+        if (state.finishedTiles.fetch_add(1, std::memory_order_acq_rel) + 1 == state.tileCount) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.finished.notify_all();
+        }
+    }
+}
+
+}  // namespace
+
+void forTiles(ThreadPool &pool, int tileCount, const std::function<void(int)> &runTile,
+              TaskPriority priority) {
+    if (tileCount <= 0) {
+        return;
+    }
+    if (tileCount == 1) {
+        runTile(0);
+        return;
+    }
+
+    auto state = std::make_shared<TileState>();
+    state->runTile = &runTile;
+    state->tileCount = tileCount;
+    const int helperCount = std::min(tileCount - 1, static_cast<int>(pool.size()));
+    for (int i = 0; i < helperCount; ++i) {
+        pool.post(priority, [state]() { runTiles(*state); });
+    }
+    runTiles(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state]() {
+        return state->finishedTiles.load(std::memory_order_acquire) == state->tileCount;
+    });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+}  // namespace Parallel
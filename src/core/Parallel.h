@@ -0,0 +1,60 @@
+#pragma once
+
+#include "core/ThreadPool.h"
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Data-parallel loops on a ThreadPool. A range is cut into tiles of `grain` elements that
+// workers claim one at a time. The calling thread claims tiles too and only waits for tiles
+// already running, so these are safe to call from inside a pool task, even one running on
+// the pool's only worker. The first exception a tile throws is rethrown in the caller.
+namespace Parallel {
+
+// Runs `runTile(tile)` once for every tile in [0, tileCount).
+void forTiles(ThreadPool &pool, int tileCount, const std::function<void(int)> &runTile,
+              TaskPriority priority = TaskPriority::Interactive);
+
+inline int tileCountFor(int begin, int end, int grain) {
+    return end > begin ? (end - begin + std::max(1, grain) - 1) / std::max(1, grain) : 0;
+}
+
+// Calls `body(first, last)` for consecutive subranges of [begin, end), each at most `grain`
+// long.
+template <typename Body>
+void forRange(ThreadPool &pool, int begin, int end, int grain, Body &&body,
+              TaskPriority priority = TaskPriority::Interactive) {
+    grain = std::max(1, grain);
+    forTiles(
+        pool, tileCountFor(begin, end, grain),
+        [&](int tile) {
+            const int first = begin + tile * grain;
+            body(first, std::min(end, first + grain));
+        },
+        priority);
+}
+
+// Maps each subrange with `map(first, last)` and folds the results with `combine`, starting
+// from `identity`. Results are combined in range order, so the outcome does not depend on
+// the number of workers.
+template <typename T, typename Map, typename Combine>
+T reduce(ThreadPool &pool, int begin, int end, int grain, T identity, Map &&map,
+         Combine &&combine, TaskPriority priority = TaskPriority::Interactive) {
+    grain = std::max(1, grain);
+    std::vector<T> partials(static_cast<std::size_t>(tileCountFor(begin, end, grain)), identity);
+    forTiles(
+        pool, static_cast<int>(partials.size()),
+        [&](int tile) {
+            const int first = begin + tile * grain;
+            partials[tile] = map(first, std::min(end, first + grain));
+        },
+        priority);
+    T result = std::move(identity);
+    for (T &partial : partials) {
+        result = combine(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+}  // namespace Parallel
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// A move-only `void()` callable for the thread pool. Callables of up to INLINE_SIZE bytes
+// that are nothrow-movable live inside the Task itself, so wrapping a typical lambda does
+// not allocate; larger ones are moved to the heap. Unlike std::function the callable may
+// itself be move-only, such as a std::packaged_task.
+class Task {
+public:
+    static constexpr std::size_t INLINE_SIZE = 48;
+
+    Task() = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F &&f) {
+        using Callable = std::decay_t<F>;
+        if constexpr (storedInline<Callable>()) {
+            ::new (static_cast<void *>(_storage)) Callable(std::forward<F>(f));
+            _ops = &INLINE_OPS<Callable>;
+        } else {
+            ::new (static_cast<void *>(_storage)) Callable *(new Callable(std::forward<F>(f)));
+            _ops = &HEAP_OPS<Callable>;
+        }
+    }
+
+    Task(Task &&other) noexcept { takeFrom(other); }
+
+    Task &operator=(Task &&other) noexcept {
+        if (this != &other) {
+            reset();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() { reset(); }
+
+    explicit operator bool() const { return _ops != nullptr; }
+
+    void operator()() { _ops->invoke(_storage); }
+
+    void reset() {
+        if (_ops) {
+            _ops->destroy(_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void *storage);
+        // Move-constructs into `to` and destroys what is left in `from`.
+        void (*relocate)(void *from, void *to);
+        void (*destroy)(void *storage);
+    };
+
+    template <typename Callable>
+    static constexpr bool storedInline() {
+        return sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t)
+               && std::is_nothrow_move_constructible_v<Callable>;
+    }
+
+    template <typename Callable>
+    static constexpr Ops INLINE_OPS = {
+        [](void *storage) { (*static_cast<Callable *>(storage))(); },
+        [](void *from, void *to) {
+            auto *source = static_cast<Callable *>(from);
+            ::new (to) Callable(std::move(*source));
+            source->~Callable();
+        },
+        [](void *storage) { static_cast<Callable *>(storage)->~Callable(); },
+    };
+
+    template <typename Callable>
+    static constexpr Ops HEAP_OPS = {
+        [](void *storage) { (**static_cast<Callable **>(storage))(); },
+        [](void *from, void *to) { ::new (to) Callable *(*static_cast<Callable **>(from)); },
+        [](void *storage) { delete *static_cast<Callable **>(storage); },
+    };
+
+    void takeFrom(Task &other) {
+        if (other._ops) {
+            other._ops->relocate(other._storage, _storage);
+            _ops = other._ops;
+            other._ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char _storage[INLINE_SIZE];
+    const Ops *_ops = nullptr;
+};
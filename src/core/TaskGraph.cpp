@@ -0,0 +1,134 @@
+#include "TaskGraph.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+struct GraphNode {
+    std::function<void()> work;
+    std::vector<std::size_t> continuations;
+    int pendingDependencies = 0;
+    bool skipped = false;
+};
+
+// Shared with the helper tasks, which may still be queued after run() has returned.
+struct GraphState {
+    std::vector<GraphNode> nodes;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::size_t> ready;
+    std::size_t unfinished = 0;
+    std::exception_ptr error;
+};
+
+// Runs ready nodes until there are none; returns the nodes it made ready beyond the first,
+// which need another thread.
+std::size_t runReadyNodes(GraphState &state, std::unique_lock<std::mutex> &lock) {
+    std::size_t spare = 0;
+    while (!state.ready.empty()) {
+        const std::size_t index = state.ready.front();
+        state.ready.pop_front();
+        GraphNode &node = state.nodes[index];
+
+        std::exception_ptr error;
+        if (!node.skipped) {
+            lock.unlock();
+            try {
+                node.work();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+        }
+        if (error && !state.error) {
+            state.error = error;
+        }
+
+        const std::size_t readyBefore = state.ready.size();
+        for (std::size_t next : node.continuations) {
+            GraphNode &continuation = state.nodes[next];
+            continuation.skipped = continuation.skipped || node.skipped || error;
+            if (--continuation.pendingDependencies == 0) {
+                state.ready.push_back(next);
+            }
+        }
+        const std::size_t madeReady = state.ready.size() - readyBefore;
+        spare += madeReady > 1 ? madeReady - 1 : 0;
+        --state.unfinished;
+        state.changed.notify_all();
+    }
+    return spare;
+}
+
+void enqueueHelpers(const std::shared_ptr<GraphState> &state, ThreadPool &pool,
+                    TaskPriority priority, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        pool.post(priority, [state, &pool, priority]() {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            const std::size_t spare = runReadyNodes(*state, lock);
+            lock.unlock();
+            enqueueHelpers(state, pool, priority, spare);
+        });
+    }
+}
+
+}  // namespace
+
+TaskGraph::NodeId TaskGraph::add(std::function<void()> work,
+                                 std::initializer_list<NodeId> dependencies) {
+    const NodeId id = _nodes.size();
+    for (NodeId dependency : dependencies) {
+        if (dependency >= id) {
+            throw std::out_of_range("TaskGraph dependency is not in the graph");
+        }
+        _nodes[dependency].continuations.push_back(id);
+    }
+    Node node;
+    node.work = std::move(work);
+    node.dependencyCount = static_cast<int>(dependencies.size());
+    _nodes.push_back(std::move(node));
+    return id;
+}
+
+void TaskGraph::run(ThreadPool &pool, TaskPriority priority) {
+    auto state = std::make_shared<GraphState>();
+    state->nodes.reserve(_nodes.size());
+    for (Node &node : _nodes) {
+        GraphNode graphNode;
+        graphNode.work = std::move(node.work);
+        graphNode.continuations = std::move(node.continuations);
+        graphNode.pendingDependencies = node.dependencyCount;
+        if (graphNode.pendingDependencies == 0) {
+            state->ready.push_back(state->nodes.size());
+        }
+        state->nodes.push_back(std::move(graphNode));
+    }
+    state->unfinished = state->nodes.size();
+    _nodes.clear();
+
+    // The caller takes one ready node; helpers take the rest.
+    const std::size_t initialReady = state->ready.size();
+    enqueueHelpers(state, pool, priority, initialReady > 1 ? initialReady - 1 : 0);
+
+    // The pool may hold the helpers back, so the caller keeps working until the graph is done.
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (state->unfinished > 0) {
+        const std::size_t spare = runReadyNodes(*state, lock);
+        if (spare > 0) {
+            lock.unlock();
+            enqueueHelpers(state, pool, priority, spare);
+            lock.lock();
+        }
+        state->changed.wait(lock, [&state]() {
+            return state->unfinished == 0 || !state->ready.empty();
+        });
+    }
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
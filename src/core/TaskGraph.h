@@ -0,0 +1,33 @@
+#pragma once
+
+#include "core/ThreadPool.h"
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+// A small dependency graph of tasks. Each node runs once all the nodes it depends on have
+// finished, which makes the nodes that depend on it its continuations. run() executes the
+// graph on a ThreadPool with the calling thread taking part, so like Parallel it may be
+// called from inside a pool task.
+class TaskGraph {
+public:
+    using NodeId = std::size_t;
+
+    // Adds a node after every node in `dependencies`, which must already be in the graph.
+    NodeId add(std::function<void()> work, std::initializer_list<NodeId> dependencies = {});
+
+    // Runs every node and returns once all have finished. If a node throws, the nodes that
+    // depend on it are skipped, the rest still run, and the first exception is rethrown.
+    // The graph is left empty.
+    void run(ThreadPool &pool, TaskPriority priority = TaskPriority::Interactive);
+
+private:
+    struct Node {
+        std::function<void()> work;
+        std::vector<NodeId> continuations;
+        int dependencyCount = 0;
+    };
+
+    std::vector<Node> _nodes;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+// Counts pool tasks that use their owner's members, so the owner's destructor can wait for
+// them before those members go away. Each task captures a Ticket, which is released when the
+// task is destroyed, whether it ran to the end, returned early or threw.
+class TaskTracker {
+public:
+    class Ticket {
+    public:
+        Ticket() = default;
+        Ticket(Ticket &&other) noexcept : _tracker(std::exchange(other._tracker, nullptr)) {}
+
+        Ticket &operator=(Ticket &&other) noexcept {
+            if (this != &other) {
+                release();
+                _tracker = std::exchange(other._tracker, nullptr);
+            }
+            return *this;
+        }
+
+        Ticket(const Ticket &) = delete;
+        Ticket &operator=(const Ticket &) = delete;
+
+        ~Ticket() { release(); }
+
+    private:
+        friend class TaskTracker;
+        explicit Ticket(TaskTracker &tracker) : _tracker(&tracker) {}
+
+        void release() {
+            if (_tracker) {
+                std::exchange(_tracker, nullptr)->finish();
+            }
+        }
+
+        TaskTracker *_tracker = nullptr;
+    };
+
+    TaskTracker() = default;
+    TaskTracker(const TaskTracker &) = delete;
+    TaskTracker &operator=(const TaskTracker &) = delete;
+
+    // Call before posting the task that will hold the ticket.
+    Ticket track() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_pending;
+        return Ticket(*this);
+    }
+
+    // Blocks until every ticket handed out so far has been released.
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle.wait(lock, [this]() { return _pending == 0; });
+    }
+
+private:
+    void finish() {
+        // Notified under the lock, so a waiter that wakes cannot destroy the tracker while
+        // this thread still uses it.
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_pending == 0) {
+            _idle.notify_all();
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _idle;
+    std::size_t _pending = 0;
+};
@@ -0,0 +1,243 @@
+#include "ThreadPool.h"
+#include "Logger.h"
+#include <exception>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Rounds of yielding an idle worker makes, looking for work, before it parks.
+constexpr int IDLE_SPIN_ROUNDS = 64;
+
+constexpr std::size_t IO_PRIORITY = static_cast<std::size_t>(TaskPriority::Io);
+
+// The pool and index of the worker running on this thread, if any.
+thread_local ThreadPool *currentPool = nullptr;
+thread_local std::size_t currentWorker = 0;
+
+// Per-thread xorshift state for picking steal victims.
+thread_local std::uint32_t victimSeed = 0x9E3779B9u;
+
+std::uint32_t nextVictimSeed() {
+    victimSeed ^= victimSeed << 13;
+    victimSeed ^= victimSeed >> 17;
+    victimSeed ^= victimSeed << 5;
+    return victimSeed;
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(std::size_t threads, std::size_t ioThreads) : _computeWorkers(threads) {
+    const std::size_t total = threads + ioThreads;
+    _workers.reserve(total);
+    for (std::size_t i = 0; i < total; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    // Every deque exists before any worker can try to steal from it.
+    for (std::size_t i = 0; i < total; ++i) {
+        _workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::Worker::~Worker() {
+    // Every node is back on a free list once the worker threads have exited.
+    for (TaskNode *list : {freeNodes, returnedNodes.load(std::memory_order_acquire)}) {
+        while (list) {
+            delete std::exchange(list, list->next);
+        }
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    // Compute tasks may still enqueue I/O, so the I/O lane drains last.
+    stopLane(_computeLot, 0, _computeWorkers);
+    stopLane(_ioLot, _computeWorkers, _workers.size());
+}
+
+void ThreadPool::stopLane(ParkingLot &lot, std::size_t firstWorker, std::size_t endWorker) {
+    {
+        std::lock_guard<std::mutex> lock(lot.mutex);
+        lot.stopping.store(true, std::memory_order_seq_cst);
+    }
+    lot.parked.notify_all();
+    for (std::size_t i = firstWorker; i < endWorker; ++i) {
+        _workers[i]->thread.join();
+    }
+}
+
+void ThreadPool::submit(TaskPriority priority, Task task) {
+    const auto level = static_cast<std::size_t>(priority);
+    // I/O tasks always go through the injection queue, so they reach the I/O lane.
+    if (currentPool == this && level != IO_PRIORITY && !isIoWorker(currentWorker)) {
+        TaskNode *node = acquireNode(currentWorker);
+        node->task = std::move(task);
+        _workers[currentWorker]->deques[level].push(node);
+    } else {
+        InjectionQueue &queue = _injected[level];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (_computeLot.stopping.load(std::memory_order_relaxed) && currentPool != this) {
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+        queue.tasks.push_back(std::move(task));
+        queue.count.fetch_add(1, std::memory_order_release);
+    }
+    wake(level == IO_PRIORITY && ioLaneSize() > 0 ? _ioLot : _computeLot);
+}
+
+ThreadPool::TaskNode *ThreadPool::acquireNode(std::size_t workerIndex) {
+    Worker &worker = *_workers[workerIndex];
+    if (!worker.freeNodes) {
+        worker.freeNodes = worker.returnedNodes.exchange(nullptr, std::memory_order_acquire);
+    }
+    if (TaskNode *node = worker.freeNodes) {
+        worker.freeNodes = node->next;
+        return node;
+    }
+    auto *node = new TaskNode;
+    node->owner = workerIndex;
+    return node;
+}
+
+void ThreadPool::releaseNode(TaskNode *node, Task &task) {
+    task = std::move(node->task);
+    Worker &owner = *_workers[node->owner];
+    if (currentPool == this && currentWorker == node->owner) {
+        node->next = owner.freeNodes;
+        owner.freeNodes = node;
+        return;
+    }
+    // The owner only ever takes the whole list, so a plain push cannot suffer ABA.
+    node->next = owner.returnedNodes.load(std::memory_order_relaxed);
+    while (!owner.returnedNodes.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                                      std::memory_order_relaxed)) {
+    }
+}
+
+void ThreadPool::wake(ParkingLot &lot) {
+    lot.epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (lot.parkingWorkers.load(std::memory_order_seq_cst) > 0) {
+        // Taking the lock orders the notify after a parking worker has started to wait.
+        { std::lock_guard<std::mutex> lock(lot.mutex); }
+        lot.parked.notify_one();
+    }
+}
+
+void ThreadPool::workerLoop(std::size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    victimSeed ^= static_cast<std::uint32_t>(index + 1) * 0x85EBCA6Bu;
+    ParkingLot &lot = lotFor(index);
+
+    Task task;
+    for (;;) {
+        if (findTask(index, task)) {
+            runTask(task);
+            continue;
+        }
+
+        bool found = false;
+        for (int round = 0; round < IDLE_SPIN_ROUNDS && !found; ++round) {
+            std::this_thread::yield();
+            found = findTask(index, task);
+        }
+        if (found) {
+            runTask(task);
+            continue;
+        }
+
+        // Announce the park before the last look, so a submit either sees the parking worker
+        // and wakes it or lands before that look and is found by it.
+        lot.parkingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        const std::uint64_t epoch = lot.epoch.load(std::memory_order_seq_cst);
+        if (findTask(index, task)) {
+            lot.parkingWorkers.fetch_sub(1, std::memory_order_relaxed);
+            runTask(task);
+            continue;
+        }
+        if (lot.stopping.load(std::memory_order_seq_cst)) {
+            lot.parkingWorkers.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(lot.mutex);
+            lot.parked.wait(lock, [this, &lot, epoch]() {
+                return lot.epoch.load(std::memory_order_seq_cst) != epoch
+                       || lot.stopping.load(std::memory_order_seq_cst);
+            });
+        }
+        lot.parkingWorkers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+bool ThreadPool::findTask(std::size_t index, Task &task) {
+    if (isIoWorker(index)) {
+        return takeInjected(IO_PRIORITY, task);
+    }
+    if (findComputeTask(index, task)) {
+        return true;
+    }
+    // Without an I/O lane, compute workers run I/O once nothing else is left.
+    return ioLaneSize() == 0 && takeInjected(IO_PRIORITY, task);
+}
+
+bool ThreadPool::findComputeTask(std::size_t index, Task &task) {
+    Worker &worker = *_workers[index];
+    for (std::size_t level = 0; level < COMPUTE_PRIORITY_COUNT; ++level) {
+        if (auto node = worker.deques[level].pop()) {
+            releaseNode(*node, task);
+            return true;
+        }
+        if (takeInjected(level, task) || steal(index, level, task)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::takeInjected(std::size_t priority, Task &task) {
+    InjectionQueue &queue = _injected[priority];
+    if (queue.count.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    queue.count.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::steal(std::size_t thiefIndex, std::size_t priority, Task &task) {
+    const std::size_t count = _computeWorkers;
+    if (count < 2) {
+        return false;
+    }
+    // Visit every other compute worker once, starting from a random one.
+    const std::size_t start = nextVictimSeed() % count;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::size_t victim = (start + i) % count;
+        WorkStealingDeque<TaskNode *> &deque = _workers[victim]->deques[priority];
+        if (victim == thiefIndex || deque.empty()) {
+            continue;
+        }
+        if (auto node = deque.steal()) {
+            releaseNode(*node, task);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTask(Task &task) {
+    try {
+        task();
+    } catch (const std::exception &ex) {
+        LOG_ERROR("ThreadPool", "Posted task failed: %s", ex.what());
+    } catch (...) {
+        LOG_ERROR("ThreadPool", "Posted task failed with unknown error.");
+    }
+    task.reset();
+}
@@ -1,71 +1,151 @@
 #pragma once
 
+#include "core/Task.h"
+#include "core/WorkStealingDeque.h"
+#include <array>
+#include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
-#include <stdexcept>
 #include <thread>
-#include <type_traits>  // For std::result_of
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
+// How urgently a task is needed. Workers always take the most urgent task they can find, so
+// a queued background recompute never runs ahead of the chunks on screen. A running task is
+// never interrupted.
+enum class TaskPriority : std::uint8_t {
+    // Blocks what the player is looking at or waiting on: visible chunks, loading screens.
+    Interactive,
+    // Will be needed soon: prefetched chunks.
+    Streaming,
+    // Results can arrive whenever: map recomputes, raster helpers.
+    Background,
+    // Blocking file access. Runs on the I/O lane when the pool has one, otherwise after
+    // every other priority.
+    Io,
+};
+
+// A work-stealing thread pool. Each compute worker owns a Chase-Lev deque per compute
+// priority: tasks enqueued from a worker go onto its own deque and are run newest first, and
+// idle workers steal the oldest tasks of the others. Tasks enqueued from any other thread go
+// through a shared injection queue per priority. A worker that finds nothing spins briefly
+// before parking, so bursts of small tasks are not held up by wake-ups. Deque entries are
+// nodes recycled through per-worker free lists, so submitting from a worker does not
+// allocate either.
+//
+// I/O tasks get their own lane of workers when `ioThreads` is non-zero. Those workers run
+// nothing else, and compute workers never take I/O tasks, so slow disk access can neither
+// occupy every compute worker nor wait behind them. Tasks still queued when the pool is
+// destroyed are run first.
 class ThreadPool {
-private:
-    std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+public:
+    explicit ThreadPool(std::size_t threads, std::size_t ioThreads = 0);
+    ~ThreadPool();
 
-    std::mutex queue_mutex;
-    std::condition_variable condition;
-    bool stop;
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
 
-public:
-    ThreadPool(size_t threads) : stop(false) {
-        for (size_t i = 0; i < threads; ++i)
-            workers.emplace_back([this] {
-                for (;;) {
-                    std::function<void()> task;
-
-                    {
-                        std::unique_lock<std::mutex> lock(this->queue_mutex);
-                        this->condition.wait(lock,
-                                             [this] { return this->stop || !this->tasks.empty(); });
-                        if (this->stop && this->tasks.empty()) return;
-                        task = std::move(this->tasks.front());
-                        this->tasks.pop();
-                    }
-
-                    task();
-                }
-            });
+    // Runs `f(args...)` and reports its result, or exception, through the returned future.
+    // The callable is held inside the task, so the future's shared state is the only
+    // allocation.
+    template <class F, class... Args>
+    auto enqueue(TaskPriority priority, F &&f, Args &&...args)
+        -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> {
+        using return_type = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+
+        std::packaged_task<return_type()> task(
+            [f = std::forward<F>(f), arguments = std::make_tuple(std::forward<Args>(args)...)]()
+                mutable -> return_type { return std::apply(std::move(f), std::move(arguments)); });
+
+        std::future<return_type> res = task.get_future();
+        submit(priority, Task(std::move(task)));
+        return res;
     }
 
+    // Enqueues at TaskPriority::Streaming.
     template <class F, class... Args>
-    auto enqueue(F &&f, Args &&...args) -> std::future<typename std::result_of<F(Args...)>::type> {
-        using return_type = typename std::result_of<F(Args...)>::type;
+    auto enqueue(F &&f, Args &&...args)
+        -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> {
+        return enqueue(TaskPriority::Streaming, std::forward<F>(f), std::forward<Args>(args)...);
+    }
 
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    // Runs `f` with nothing to report back. Does not allocate when `f` fits in a Task, so
+    // this is the cheapest way to submit work; results can be handed over by `f` itself.
+    // An exception escaping `f` is logged and dropped.
+    template <class F>
+    void post(TaskPriority priority, F &&f) {
+        submit(priority, Task(std::forward<F>(f)));
+    }
 
-        std::future<return_type> res = task->get_future();
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex);
+    // Compute workers; the I/O lane is not counted.
+    std::size_t size() const { return _computeWorkers; }
+    std::size_t ioLaneSize() const { return _workers.size() - _computeWorkers; }
 
-            if (stop) throw std::runtime_error("enqueue on stopped ThreadPool");
+private:
+    static constexpr std::size_t PRIORITY_COUNT = 4;
+    // Interactive, Streaming and Background; the priorities compute workers keep deques for.
+    static constexpr std::size_t COMPUTE_PRIORITY_COUNT = 3;
 
-            tasks.emplace([task]() { (*task)(); });
-        }
-        condition.notify_one();
-        return res;
-    }
+    // A task on a worker's deque. Owned by the worker that allocated it, which reuses it.
+    struct TaskNode {
+        Task task;
+        TaskNode *next = nullptr;
+        std::size_t owner = 0;
+    };
 
-    ~ThreadPool() {
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            stop = true;
-        }
-        condition.notify_all();
-        for (std::thread &worker : workers)
-            worker.join();
-    }
+    struct Worker {
+        ~Worker();
+
+        std::array<WorkStealingDeque<TaskNode *>, COMPUTE_PRIORITY_COUNT> deques;
+        std::thread thread;
+        // Nodes ready for reuse: `freeNodes` is the owner's alone, other workers hand
+        // back the nodes they stole through `returnedNodes`.
+        TaskNode *freeNodes = nullptr;
+        std::atomic<TaskNode *> returnedNodes{nullptr};
+    };
+
+    struct InjectionQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        // Read without the lock so idle workers can skip an empty queue.
+        std::atomic<std::size_t> count{0};
+    };
+
+    // Where the workers of one lane park. Bumped on every submit to the lane; a parked
+    // worker sleeps until the epoch changes. Workers exit once the lane is stopping and
+    // they find nothing left to run.
+    struct ParkingLot {
+        std::mutex mutex;
+        std::condition_variable parked;
+        std::atomic<std::uint64_t> epoch{0};
+        std::atomic<int> parkingWorkers{0};
+        std::atomic<bool> stopping{false};
+    };
+
+    void submit(TaskPriority priority, Task task);
+    void workerLoop(std::size_t index);
+    // Each moves the task it finds into `task` and returns whether there was one.
+    bool findTask(std::size_t index, Task &task);
+    bool findComputeTask(std::size_t index, Task &task);
+    bool takeInjected(std::size_t priority, Task &task);
+    bool steal(std::size_t thiefIndex, std::size_t priority, Task &task);
+    void runTask(Task &task);
+    TaskNode *acquireNode(std::size_t workerIndex);
+    void releaseNode(TaskNode *node, Task &task);
+    void wake(ParkingLot &lot);
+    void stopLane(ParkingLot &lot, std::size_t firstWorker, std::size_t endWorker);
+    bool isIoWorker(std::size_t index) const { return index >= _computeWorkers; }
+    ParkingLot &lotFor(std::size_t index) { return isIoWorker(index) ? _ioLot : _computeLot; }
+
+    std::size_t _computeWorkers = 0;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::array<InjectionQueue, PRIORITY_COUNT> _injected;
+    ParkingLot _computeLot;
+    ParkingLot _ioLot;
 };
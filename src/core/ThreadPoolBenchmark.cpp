@@ -0,0 +1,132 @@
+#include "ThreadPoolBenchmark.h"
+#include "core/SharedQueueThreadPool.h"
+#include "core/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace ThreadPoolBenchmark {
+
+namespace {
+
+// A few dozen nanoseconds of work, so the timing is dominated by scheduling.
+void spinWork(std::atomic<std::uint64_t> &sink, int seed) {
+    std::uint64_t value = static_cast<std::uint64_t>(seed) | 1u;
+    for (int i = 0; i < 16; ++i) {
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    sink.fetch_add(value & 1u, std::memory_order_relaxed);
+}
+
+// Shared with the tasks, so it outlives the last one even after the round has returned.
+struct RoundState {
+    std::atomic<int> remaining{0};
+    std::atomic<std::uint64_t> sink{0};
+    std::promise<void> done;
+};
+
+template <typename Pool>
+double timeRound(Pool &pool, int rootTasks, int childrenPerRoot) {
+    auto state = std::make_shared<RoundState>();
+    state->remaining.store(rootTasks * childrenPerRoot, std::memory_order_relaxed);
+    auto finished = state->done.get_future();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int root = 0; root < rootTasks; ++root) {
+        pool.enqueue([&pool, state, root, childrenPerRoot]() {
+            for (int child = 0; child < childrenPerRoot; ++child) {
+                pool.enqueue([state, seed = root * childrenPerRoot + child]() {
+                    spinWork(state->sink, seed);
+                    if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        state->done.set_value();
+                    }
+                });
+            }
+        });
+    }
+    finished.wait();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+template <typename Pool>
+double timePool(int threads, int rootTasks, int childrenPerRoot, int repetitions) {
+    Pool pool(static_cast<std::size_t>(threads));
+    double total = 0.0;
+    for (int i = 0; i < repetitions; ++i) {
+        total += timeRound(pool, rootTasks, childrenPerRoot);
+    }
+    return total;
+}
+
+enum class Submission { Wrapped, Enqueue, Post };
+
+// Times only the submitting loop; the round still waits for the tasks before returning.
+double timeSubmission(ThreadPool &pool, Submission submission, int tasks) {
+    auto state = std::make_shared<RoundState>();
+    state->remaining.store(tasks, std::memory_order_relaxed);
+    auto finished = state->done.get_future();
+    std::vector<std::future<void>> futures;
+    futures.reserve(submission == Submission::Enqueue ? tasks : 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < tasks; ++i) {
+        auto work = [state, i]() {
+            spinWork(state->sink, i);
+            if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                state->done.set_value();
+            }
+        };
+        switch (submission) {
+        case Submission::Wrapped: {
+            auto task = std::make_shared<std::packaged_task<void()>>(std::bind(work));
+            pool.post(TaskPriority::Streaming, std::function<void()>([task]() { (*task)(); }));
+            break;
+        }
+        case Submission::Enqueue:
+            futures.push_back(pool.enqueue(TaskPriority::Streaming, work));
+            break;
+        case Submission::Post:
+            pool.post(TaskPriority::Streaming, work);
+            break;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    finished.wait();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+std::vector<Result> run(int maxThreads, int rootTasks, int childrenPerRoot, int submittedTasks,
+                        int repetitions) {
+    std::vector<Result> results;
+    rootTasks = std::max(1, rootTasks);
+    childrenPerRoot = std::max(1, childrenPerRoot);
+    submittedTasks = std::max(1, submittedTasks);
+    for (int threads = 1; threads <= std::max(1, maxThreads); threads *= 2) {
+        Result result;
+        result.threads = threads;
+        result.tasks = rootTasks * (childrenPerRoot + 1) * repetitions;
+        result.sharedQueueMs =
+            timePool<SharedQueueThreadPool>(threads, rootTasks, childrenPerRoot, repetitions);
+        result.workStealingMs =
+            timePool<ThreadPool>(threads, rootTasks, childrenPerRoot, repetitions);
+
+        ThreadPool pool(static_cast<std::size_t>(threads));
+        result.submittedTasks = submittedTasks * repetitions;
+        for (int i = 0; i < repetitions; ++i) {
+            result.wrappedSubmitMs += timeSubmission(pool, Submission::Wrapped, submittedTasks);
+            result.enqueueSubmitMs += timeSubmission(pool, Submission::Enqueue, submittedTasks);
+            result.postSubmitMs += timeSubmission(pool, Submission::Post, submittedTasks);
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+}  // namespace ThreadPoolBenchmark
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+// Measures scheduling overhead and lock contention of the work-stealing ThreadPool against
+// the single-queue SharedQueueThreadPool it replaced, and the cost of submitting a task.
+namespace ThreadPoolBenchmark {
+
+struct Result {
+    int threads = 0;
+    int tasks = 0;
+    double sharedQueueMs = 0.0;
+    double workStealingMs = 0.0;
+    // Time to submit `submittedTasks` tasks from the calling thread: wrapped the way tasks
+    // were before Task (std::function around a shared std::packaged_task), through
+    // enqueue() with a future, and through post().
+    int submittedTasks = 0;
+    double wrappedSubmitMs = 0.0;
+    double enqueueSubmitMs = 0.0;
+    double postSubmitMs = 0.0;
+};
+
+// For each thread count from 1 to `maxThreads`, doubling, times `repetitions` rounds of
+// `rootTasks` tasks enqueued from the calling thread, each of which enqueues
+// `childrenPerRoot` small tasks from inside the pool. Submission is timed over
+// `submittedTasks` tasks per round.
+std::vector<Result> run(int maxThreads, int rootTasks, int childrenPerRoot, int submittedTasks,
+                        int repetitions);
+
+}  // namespace ThreadPoolBenchmark
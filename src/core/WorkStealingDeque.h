@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// A Chase-Lev work-stealing deque (Lê et al., "Correct and Efficient Work-Stealing for Weak
+// Memory Models"). One owner thread pushes and pops at the bottom; any thread may steal from
+// the top. The buffer doubles when full. Outgrown buffers stay allocated until the deque is
+// destroyed, since a thief may still be reading one.
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "Deque items are copied without locking.");
+
+public:
+    explicit WorkStealingDeque(std::int64_t capacity = 256) {
+        _buffers.push_back(std::make_unique<Buffer>(capacity));
+        _buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    // Owner only.
+    void push(T item) {
+        const std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        const std::int64_t top = _top.load(std::memory_order_acquire);
+        Buffer *buffer = _buffer.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->capacity - 1) {
+            buffer = grow(buffer, top, bottom);
+        }
+        buffer->store(bottom, item);
+        // Publishes the item, and whatever it points to, to thieves that see the new bottom.
+        _bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    // Owner only. Takes the most recently pushed item.
+    std::optional<T> pop() {
+        const std::int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = _buffer.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = _top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        T item = buffer->load(bottom);
+        if (top == bottom) {
+            // The last item; race any thief for it.
+            const bool won = _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            if (!won) {
+                return std::nullopt;
+            }
+        }
+        return item;
+    }
+
+    // Any thread. Takes the oldest item; fails when empty or on losing a race for it.
+    std::optional<T> steal() {
+        std::int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return std::nullopt;
+        }
+        T item = _buffer.load(std::memory_order_acquire)->load(top);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return item;
+    }
+
+    // A snapshot that may be stale by the time it is read.
+    bool empty() const {
+        return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(std::int64_t size)
+            : capacity(size), mask(size - 1), slots(std::make_unique<std::atomic<T>[]>(size)) {}
+
+        T load(std::int64_t index) const {
+            return slots[index & mask].load(std::memory_order_relaxed);
+        }
+        void store(std::int64_t index, T item) {
+            slots[index & mask].store(item, std::memory_order_relaxed);
+        }
+
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Buffer *grow(Buffer *buffer, std::int64_t top, std::int64_t bottom) {
+        auto grown = std::make_unique<Buffer>(buffer->capacity * 2);
+        for (std::int64_t i = top; i < bottom; ++i) {
+            grown->store(i, buffer->load(i));
+        }
+        _buffers.push_back(std::move(grown));
+        Buffer *next = _buffers.back().get();
+        _buffer.store(next, std::memory_order_release);
+        return next;
+    }
+
+    alignas(64) std::atomic<std::int64_t> _top{0};
+    alignas(64) std::atomic<std::int64_t> _bottom{0};
+    std::atomic<Buffer *> _buffer{nullptr};
+    // Owner only; holds every buffer the deque has used.
+    std::vector<std::unique_ptr<Buffer>> _buffers;
+};
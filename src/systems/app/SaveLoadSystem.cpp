@@ -9,6 +9,7 @@
 #include "components/RenderComponents.h"
 #include "components/TrainComponents.h"
 #include "components/WorldComponents.h"
+#include "core/ThreadPool.h"
 #include "event/LineEvents.h"
 #include "event/UIEvents.h"
 #include "render/Camera.h"
@@ -19,6 +20,7 @@
 #include "world/WorldData.h"
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Graphics/Color.hpp>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <optional>
@@ -179,10 +181,11 @@ SaveLoadSystem::SaveLoadSystem(entt::registry &registry, EventBus &eventBus,
                                ChunkManagerSystem &chunkManagerSystem,
                                CityPlacementSystem &cityPlacementSystem,
                                PassengerSpawnSystem &passengerSpawnSystem, GameState &gameState,
-                               Camera &camera)
+                               Camera &camera, ThreadPool &threadPool)
     : _registry(registry), _eventBus(eventBus), _worldGenSystem(worldGenSystem),
       _chunkManagerSystem(chunkManagerSystem), _cityPlacementSystem(cityPlacementSystem),
-      _passengerSpawnSystem(passengerSpawnSystem), _gameState(gameState), _camera(camera) {
+      _passengerSpawnSystem(passengerSpawnSystem), _gameState(gameState), _camera(camera),
+      _threadPool(threadPool) {
     _saveConnection =
         _eventBus.sink<SaveGameRequestEvent>().connect<&SaveLoadSystem::onSaveGame>(this);
     _loadConnection =
@@ -190,6 +193,9 @@ SaveLoadSystem::SaveLoadSystem(entt::registry &registry, EventBus &eventBus,
 }
 
 SaveLoadSystem::~SaveLoadSystem() {
+    if (_pendingSave.valid()) {
+        _pendingSave.wait();
+    }
     _saveConnection.release();
     _loadConnection.release();
 }
@@ -213,19 +219,32 @@ void SaveLoadSystem::onSaveGame(const SaveGameRequestEvent &event) {
         root["passenger_spawn"] = serializePassengerSpawn();
         root["camera"] = serializeCamera();
 
-        std::ofstream out(path);
-        if (!out) {
-            LOG_ERROR("SaveLoadSystem", "Failed to open file for saving: %s", event.path.c_str());
-            return;
-        }
-        out << root.dump(2);
-        LOG_INFO("SaveLoadSystem", "Game saved to %s", event.path.c_str());
+        // The game state is captured above; only the file write is left to the I/O lane, so a
+        // slow disk neither stalls the frame nor takes a compute worker.
+        if (_pendingSave.valid()) {
+            _pendingSave.wait();
+        }
+        _pendingSave = _threadPool.enqueue(
+            TaskPriority::Io, [path = event.path, text = root.dump(2)]() {
+                std::ofstream out(path);
+                if (!out) {
+                    LOG_ERROR("SaveLoadSystem", "Failed to open file for saving: %s",
+                              path.c_str());
+                    return;
+                }
+                out << text;
+                LOG_INFO("SaveLoadSystem", "Game saved to %s", path.c_str());
+            });
     } catch (const std::exception &ex) {
         LOG_ERROR("SaveLoadSystem", "Save failed: %s", ex.what());
     }
 }
 
 void SaveLoadSystem::onLoadGame(const LoadGameRequestEvent &event) {
+    // Loading the file a save is still writing would read it half written.
+    if (_pendingSave.valid()) {
+        _pendingSave.wait();
+    }
     try {
         std::filesystem::path path(event.path);
         if (!std::filesystem::exists(path)) {
@@ -347,6 +366,9 @@ nlohmann::json SaveLoadSystem::serializeWorldGenParams(const WorldGenParams &par
 
     result["elevation"] = {{"max_elevation", params.elevation.maxElevation},
                            {"exponent", params.elevation.elevationExponent}};
+    result["octave_split"] = {{"enabled", params.octaveSplit.enabled},
+                              {"cutoff_frequency", params.octaveSplit.cutoffFrequency},
+                              {"max_error", params.octaveSplit.maxError}};
 
     result["world_dimensions_in_chunks"] = {{"x", params.worldDimensionsInChunks.x},
                                             {"y", params.worldDimensionsInChunks.y}};
@@ -394,6 +416,14 @@ WorldGenParams SaveLoadSystem::deserializeWorldGenParams(const nlohmann::json &d
         params.elevation.elevationExponent = elev.value("exponent", 1.0f);
     }
 
+    if (data.contains("octave_split")) {
+        const auto &split = data["octave_split"];
+        params.octaveSplit.enabled = split.value("enabled", params.octaveSplit.enabled);
+        params.octaveSplit.cutoffFrequency =
+            split.value("cutoff_frequency", params.octaveSplit.cutoffFrequency);
+        params.octaveSplit.maxError = split.value("max_error", params.octaveSplit.maxError);
+    }
+
     if (data.contains("world_dimensions_in_chunks")) {
         params.worldDimensionsInChunks.x =
             data["world_dimensions_in_chunks"].value("x", params.worldDimensionsInChunks.x);
@@ -451,6 +481,8 @@ nlohmann::json SaveLoadSystem::serializeChunks() const {
                                     const ChunkElevationComponent>();
     for (auto entity : chunkView) {
         const auto &pos = chunkView.get<const ChunkPositionComponent>(entity);
+        // Coarser LOD chunks are regenerated from the saved params on demand.
+        if (pos.lodLevel != 0) continue;
         const auto &terrain = chunkView.get<const ChunkTerrainComponent>(entity);
         const auto &elevation = chunkView.get<const ChunkElevationComponent>(entity);
 
@@ -459,16 +491,17 @@ nlohmann::json SaveLoadSystem::serializeChunks() const {
         chunk["y"] = pos.chunkGridPosition.y;
 
         nlohmann::json cells = nlohmann::json::array();
-        for (TerrainType type : terrain.cells) {
-            cells.push_back(static_cast<int>(type));
+        for (std::size_t i = 0; i < terrain.cells.size(); ++i) {
+            cells.push_back(static_cast<int>(terrain.cells[i]));
         }
         chunk["cells"] = cells;
 
         nlohmann::json elevations = nlohmann::json::array();
-        for (float value : elevation.elevations) {
-            elevations.push_back(value);
+        for (std::size_t i = 0; i < elevation.elevations.size(); ++i) {
+            elevations.push_back(elevation.elevations[i]);
         }
         chunk["elevations"] = elevations;
+        chunk["max_elevation"] = elevation.elevations.getMaxElevation();
 
         chunks.push_back(chunk);
     }
@@ -488,14 +521,23 @@ std::vector<GeneratedChunkData> SaveLoadSystem::deserializeChunks(
         chunk.chunkGridPosition.x = chunkData.value("x", 0);
         chunk.chunkGridPosition.y = chunkData.value("y", 0);
         if (chunkData.contains("cells")) {
-            for (const auto &cell : chunkData["cells"]) {
-                chunk.cells.push_back(terrainFromInt(cell.get<int>()));
+            const auto &cells = chunkData["cells"];
+            chunk.cells.assign(cells.size(), TerrainType::WATER);
+            for (std::size_t i = 0; i < cells.size(); ++i) {
+                chunk.cells.set(i, terrainFromInt(cells[i].get<int>()));
             }
+            chunk.cells.compact();
         }
         if (chunkData.contains("elevations")) {
+            std::vector<float> elevations;
             for (const auto &elev : chunkData["elevations"]) {
-                chunk.elevations.push_back(elev.get<float>());
+                elevations.push_back(elev.get<float>());
             }
+            // Saves without a scale predate quantized elevations; their largest value is used.
+            const float fallbackMax =
+                elevations.empty() ? 0.0f : *std::max_element(elevations.begin(), elevations.end());
+            chunk.elevations.assign(elevations.data(), elevations.size(),
+                                    chunkData.value("max_elevation", fallbackMax));
         }
         chunks.push_back(std::move(chunk));
     }
@@ -1078,8 +1120,8 @@ nlohmann::json SaveLoadSystem::serializeCityPlacement() const {
     data["placed_cities"] = placedCities;
 
     nlohmann::json terrainCache = nlohmann::json::array();
-    for (auto terrain : state.terrainCache) {
-        terrainCache.push_back(static_cast<int>(terrain));
+    for (std::size_t i = 0; i < state.terrainCache.size(); ++i) {
+        terrainCache.push_back(static_cast<int>(state.terrainCache[i]));
     }
     data["terrain_cache"] = terrainCache;
 
@@ -1155,8 +1197,10 @@ void SaveLoadSystem::applyCityPlacement(const nlohmann::json &data) {
 
     state.terrainCache.clear();
     if (data.contains("terrain_cache")) {
-        for (const auto &terrainValue : data["terrain_cache"]) {
-            state.terrainCache.push_back(terrainFromInt(terrainValue.get<int>()));
+        const auto &terrainCache = data["terrain_cache"];
+        state.terrainCache.assign(terrainCache.size(), TerrainType::WATER);
+        for (std::size_t i = 0; i < terrainCache.size(); ++i) {
+            state.terrainCache.set(i, terrainFromInt(terrainCache[i].get<int>()));
         }
     }
 
@@ -3,6 +3,7 @@
 #include "ecs/ISystem.h"
 #include "event/EventBus.h"
 #include <entt/entt.hpp>
+#include <future>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
@@ -14,6 +15,7 @@ class ChunkManagerSystem;
 class CityPlacementSystem;
 class PassengerSpawnSystem;
 class Camera;
+class ThreadPool;
 struct GameState;
 struct GeneratedChunkData;
 struct WorldGenParams;
@@ -26,7 +28,8 @@ public:
                    WorldGenerationSystem &worldGenSystem,
                    ChunkManagerSystem &chunkManagerSystem,
                    CityPlacementSystem &cityPlacementSystem,
-                   PassengerSpawnSystem &passengerSpawnSystem, GameState &gameState, Camera &camera);
+                   PassengerSpawnSystem &passengerSpawnSystem, GameState &gameState, Camera &camera,
+                   ThreadPool &threadPool);
     ~SaveLoadSystem() override;
 
 private:
@@ -69,6 +72,9 @@ private:
     PassengerSpawnSystem &_passengerSpawnSystem;
     GameState &_gameState;
     Camera &_camera;
+    ThreadPool &_threadPool;
+    // The file write of the last save, running on the I/O lane.
+    std::future<void> _pendingSave;
     entt::scoped_connection _saveConnection;
     entt::scoped_connection _loadConnection;
 };
@@ -7,17 +7,34 @@
 #include "render/Renderer.h" 
 #include "Constants.h"
 #include "app/LoadingState.h"
+#include "core/Parallel.h"
+#include "core/TaskGraph.h"
 #include "core/ThreadPool.h"
+#include "world/SimdKernels.h"
+#include "world/WorldRaster.h"
 #include <vector>
 #include <algorithm>
 #include <random>
-#include <queue>
 #include <chrono>
 #include <sstream>
 
-CityPlacementSystem::CityPlacementSystem(LoadingState& loadingState, WorldGenerationSystem& worldGenerationSystem, EntityFactory& entityFactory, Renderer& renderer, EventBus& eventBus, PerformanceMonitor& performanceMonitor, ThreadPool& threadPool)
+namespace {
+
+// Whole rows, or whole columns, per tile of a parallel map pass.
+int rowGrain(int mapWidth) {
+    return std::max(1, Constants::SUITABILITY_TILE_CELLS / std::max(1, mapWidth));
+}
+
+int columnGrain(int mapHeight) {
+    return std::max(1, Constants::SUITABILITY_TILE_CELLS / std::max(1, mapHeight));
+}
+
+}  // namespace
+
+CityPlacementSystem::CityPlacementSystem(LoadingState& loadingState, WorldGenerationSystem& worldGenerationSystem, WorldRaster& worldRaster, EntityFactory& entityFactory, Renderer& renderer, EventBus& eventBus, PerformanceMonitor& performanceMonitor, ThreadPool& threadPool)
     : _loadingState(loadingState), 
       _worldGenerationSystem(worldGenerationSystem), 
+      _worldRaster(worldRaster),
       _entityFactory(entityFactory), 
       _renderer(renderer),
       _eventBus(eventBus),
@@ -40,6 +57,12 @@ CityPlacementSystem::CityPlacementSystem(LoadingState& loadingState, WorldGenera
 }
 
 CityPlacementSystem::~CityPlacementSystem() {
+    // Queued map refreshes return once they see this; a regeneration in progress finishes.
+    // The future shares ownership of the regeneration task, and with it the task's ticket,
+    // so it is dropped before waiting.
+    _shuttingDown.store(true);
+    _regenerationTask = {};
+    _placementTasks.wait();
     LOG_DEBUG("CityPlacementSystem", "CityPlacementSystem destroyed.");
 }
 
@@ -121,7 +144,7 @@ void CityPlacementSystem::applySerializedState(const CityPlacementSerializedStat
 }
 
 void CityPlacementSystem::init() {
-    initialPlacement(false);
+    initialPlacement(false, _worldGenerationSystem.getSnapshot());
 }
 
 void CityPlacementSystem::onRegenerateEntities(const RegenerateEntitiesEvent &) {
@@ -139,9 +162,12 @@ void CityPlacementSystem::onRegenerateEntities(const RegenerateEntitiesEvent &)
     _loadingState.progress = 0.05f;
     _loadingState.showOverlay = true;
 
-    _regenerationTask = _threadPool.enqueue([this]() {
+    // Runs behind the loading overlay, which the player is waiting on.
+    auto snapshot = _worldGenerationSystem.getSnapshot();
+    _regenerationTask = _threadPool.enqueue(TaskPriority::Interactive,
+                                            [this, ticket = _placementTasks.track(), snapshot]() {
         try {
-            initialPlacement(true);
+            initialPlacement(true, snapshot);
         } catch (const std::exception &ex) {
             LOG_ERROR("CityPlacementSystem", "Entity regeneration failed: %s", ex.what());
             _isRegenerating.store(false);
@@ -186,7 +212,8 @@ void CityPlacementSystem::update(sf::Time dt) {
     }
 }
 
-void CityPlacementSystem::initialPlacement(bool isRegeneration) {
+void CityPlacementSystem::initialPlacement(bool isRegeneration,
+                                           std::shared_ptr<const WorldGenSnapshot> snapshot) {
     const char *timerLabel = isRegeneration ? "CityPlacementSystem::regenerateEntities"
                                             : "CityPlacementSystem::initialPlacement";
     PerfTimer timer(timerLabel, _performanceMonitor, PerfTimer::Purpose::Log);
@@ -194,7 +221,8 @@ void CityPlacementSystem::initialPlacement(bool isRegeneration) {
     LOG_INFO("CityPlacementSystem", isRegeneration ? "Regenerating city placement pipeline..."
                                                    : "Starting initial city placement...");
 
-    const auto &worldGrid = _worldGenerationSystem.getParams();
+    // The settings UI edits the live params in place, so the grid comes from the snapshot.
+    const auto &worldGrid = snapshot->params;
     const int mapWidth = worldGrid.worldDimensionsInChunks.x * worldGrid.chunkDimensionsInCells.x;
     const int mapHeight = worldGrid.worldDimensionsInChunks.y * worldGrid.chunkDimensionsInCells.y;
 
@@ -202,7 +230,14 @@ void CityPlacementSystem::initialPlacement(bool isRegeneration) {
 
     _loadingState.message = isRegeneration ? "Regenerating terrain cache..." : "Analyzing terrain...";
     _loadingState.progress = 0.1f;
-    precomputeTerrainCache(mapWidth, mapHeight);
+    if (!precomputeTerrainCache(snapshot)) {
+        LOG_WARN("CityPlacementSystem",
+                 "World was regenerated during city placement; regenerate entities to place "
+                 "cities on the new world.");
+        _isRegenerating.store(false);
+        _loadingState.showOverlay = false;
+        return;
+    }
 
     _loadingState.message = "Building suitability baselines...";
     _loadingState.progress = 0.3f;
@@ -212,7 +247,7 @@ void CityPlacementSystem::initialPlacement(bool isRegeneration) {
     LOG_INFO("CityPlacementSystem", "Placing initial settlements...");
     _loadingState.message = "Placing initial settlements...";
     _loadingState.progress = 0.62f;
-    placeInitialCapitals(mapWidth, mapHeight);
+    placeInitialCapitals(mapWidth, mapHeight, worldGrid.cellSize);
 
     LOG_INFO("CityPlacementSystem", "Calculating initial town and suburb suitability maps...");
     _loadingState.message = "Calculating dependent suitability maps...";
@@ -232,6 +267,11 @@ void CityPlacementSystem::initialPlacement(bool isRegeneration) {
     _loadingState.showOverlay = false;
 }
 
+TaskPriority CityPlacementSystem::mapPriority() const {
+    // Before the first placement the maps hold up loading; afterwards they are refreshes.
+    return _initialPlacementDone ? TaskPriority::Background : TaskPriority::Interactive;
+}
+
 void CityPlacementSystem::resetPlacementState() {
     std::scoped_lock<std::mutex> lock(_mapUpdateMutex);
     _placedCities.clear();
@@ -289,8 +329,9 @@ void CityPlacementSystem::asyncUpdateMaps(PlacedCityInfo newCity) {
         return;
     }
 
-    _threadPool.enqueue([this, newCity] {
-        if (_isRegenerating.load()) {
+    // A full-map recompute; it must not hold up the chunks on screen.
+    _threadPool.post(TaskPriority::Background, [this, ticket = _placementTasks.track(), newCity] {
+        if (_isRegenerating.load() || _shuttingDown.load()) {
             return;
         }
 
@@ -331,224 +372,300 @@ void CityPlacementSystem::updateDistanceMaps(const PlacedCityInfo &newCity, int
         return; // Suburbs don't influence placement of other cities
     }
 
-    std::queue<sf::Vector2i> q;
-    if ((*distanceMap)[newCity.position.y * mapWidth + newCity.position.x] > 0) {
-        q.push(newCity.position);
-        (*distanceMap)[newCity.position.y * mapWidth + newCity.position.x] = 0;
-    } else {
+    if ((*distanceMap)[newCity.position.y * mapWidth + newCity.position.x] <= 0) {
         return; // Already processed
     }
 
-    int dx[] = {0, 0, 1, -1, 1, 1, -1, -1};
-    int dy[] = {1, -1, 0, 0, 1, -1, 1, -1};
-
-    while (!q.empty()) {
-        sf::Vector2i curr = q.front();
-        q.pop();
-
-        int d = (*distanceMap)[curr.y * mapWidth + curr.x];
-
-        for (int i = 0; i < 8; ++i) {
-            int nx = curr.x + dx[i];
-            int ny = curr.y + dy[i];
-
-            if (nx >= 0 && nx < mapWidth && ny >= 0 && ny < mapHeight) {
-                int newDist = d + 1;
-                if (newDist < (*distanceMap)[ny * mapWidth + nx]) {
-                    (*distanceMap)[ny * mapWidth + nx] = newDist;
-                    q.push({nx, ny});
+    // Distance spreads to all eight neighbours on an open grid, so a city's distance field is
+    // the Chebyshev distance to it; each cell keeps the nearer of that and the cities before.
+    const sf::Vector2i city = newCity.position;
+    std::vector<int> &distances = *distanceMap;
+    Parallel::forRange(
+        _threadPool, 0, mapHeight, rowGrain(mapWidth),
+        [&](int firstRow, int lastRow) {
+            for (int y = firstRow; y < lastRow; ++y) {
+                const int dy = std::abs(y - city.y);
+                int *row = distances.data() + static_cast<std::size_t>(y) * mapWidth;
+                for (int x = 0; x < mapWidth; ++x) {
+                    row[x] = std::min(row[x], std::max(dy, std::abs(x - city.x)));
                 }
             }
-        }
-    }
+        },
+        mapPriority());
 }
 
 void CityPlacementSystem::calculateCapitalProximitySuitability(int mapWidth, int mapHeight, std::vector<float> &map) {
     const float idealDist = Constants::CITY_PROXIMITY_IDEAL_DISTANCE;
 
-    for (int i = 0; i < mapWidth * mapHeight; ++i) {
-        if (_distanceToNearestCapital[i] == std::numeric_limits<int>::max()) {
-            map[i] = 1.0f;
-            continue;
-        }
+    Parallel::forRange(
+        _threadPool, 0, mapWidth * mapHeight, Constants::SUITABILITY_TILE_CELLS,
+        [&](int first, int last) {
+            for (int i = first; i < last; ++i) {
+                if (_distanceToNearestCapital[i] == std::numeric_limits<int>::max()) {
+                    map[i] = 1.0f;
+                    continue;
+                }
 
-        float d = static_cast<float>(_distanceToNearestCapital[i]);
-        float dist_from_ideal = std::abs(d - idealDist);
-        float score = std::max(0.0f, 1.0f - dist_from_ideal / idealDist);
-        map[i] = score * score * (3.0f - 2.0f * score);
-    }
+                float d = static_cast<float>(_distanceToNearestCapital[i]);
+                float dist_from_ideal = std::abs(d - idealDist);
+                float score = std::max(0.0f, 1.0f - dist_from_ideal / idealDist);
+                map[i] = score * score * (3.0f - 2.0f * score);
+            }
+        },
+        mapPriority());
 }
 
 void CityPlacementSystem::calculateSuburbProximitySuitability(int mapWidth, int mapHeight, std::vector<float> &map) {
     const float capitalRange = Constants::SUBURB_PROXIMITY_RANGE_CAPITAL;
     const float townRange = Constants::SUBURB_PROXIMITY_RANGE_TOWN;
 
-    for (int i = 0; i < mapWidth * mapHeight; ++i) {
-        float distToCapital = static_cast<float>(_distanceToNearestCapital[i]);
-        float distToTown = static_cast<float>(_distanceToNearestTown[i]);
+    Parallel::forRange(
+        _threadPool, 0, mapWidth * mapHeight, Constants::SUITABILITY_TILE_CELLS,
+        [&](int first, int last) {
+            for (int i = first; i < last; ++i) {
+                float distToCapital = static_cast<float>(_distanceToNearestCapital[i]);
+                float distToTown = static_cast<float>(_distanceToNearestTown[i]);
 
-        float score = 0.0f;
-        if (distToCapital < capitalRange) {
-            score = std::max(score, 1.0f - distToCapital / capitalRange);
-        }
-        if (distToTown < townRange) {
-            score = std::max(score, 1.0f - distToTown / townRange);
-        }
-        map[i] = score;
-    }
+                float score = 0.0f;
+                if (distToCapital < capitalRange) {
+                    score = std::max(score, 1.0f - distToCapital / capitalRange);
+                }
+                if (distToTown < townRange) {
+                    score = std::max(score, 1.0f - distToTown / townRange);
+                }
+                map[i] = score;
+            }
+        },
+        mapPriority());
 }
 
 void CityPlacementSystem::calculateTownProximitySuitability(int mapWidth, int mapHeight, std::vector<float> &map) {
     const float min_dist = Constants::TOWN_PROXIMITY_MIN_DISTANCE;
     const float max_dist = Constants::TOWN_PROXIMITY_MAX_DISTANCE;
 
-    for (int i = 0; i < mapWidth * mapHeight; ++i) {
-        float distToCapital = static_cast<float>(_distanceToNearestCapital[i]);
-        float distToTown = static_cast<float>(_distanceToNearestTown[i]);
-        float minDist = std::min(distToCapital, distToTown);
-
-        if (minDist < min_dist) {
-            map[i] = 0.0f;
-        } else if (minDist > max_dist) {
-            map[i] = 1.0f;
-        } else {
-            map[i] = (minDist - min_dist) / (max_dist - min_dist);
-        }
-    }
+    Parallel::forRange(
+        _threadPool, 0, mapWidth * mapHeight, Constants::SUITABILITY_TILE_CELLS,
+        [&](int first, int last) {
+            for (int i = first; i < last; ++i) {
+                float distToCapital = static_cast<float>(_distanceToNearestCapital[i]);
+                float distToTown = static_cast<float>(_distanceToNearestTown[i]);
+                float minDist = std::min(distToCapital, distToTown);
+
+                if (minDist < min_dist) {
+                    map[i] = 0.0f;
+                } else if (minDist > max_dist) {
+                    map[i] = 1.0f;
+                } else {
+                    map[i] = (minDist - min_dist) / (max_dist - min_dist);
+                }
+            }
+        },
+        mapPriority());
 }
 
-void CityPlacementSystem::precomputeTerrainCache(int mapWidth, int mapHeight) {
+bool CityPlacementSystem::precomputeTerrainCache(
+    const std::shared_ptr<const WorldGenSnapshot> &snapshot) {
     PerfTimer timer("CityPlacementSystem::precomputeTerrainCache", _performanceMonitor, PerfTimer::Purpose::Log);
-    const float cellSize = _worldGenerationSystem.getParams().cellSize;
-
-    _terrainCache.resize(mapWidth * mapHeight);
-    for (int y = 0; y < mapHeight; ++y) {
-        for (int x = 0; x < mapWidth; ++x) {
-            _terrainCache[y * mapWidth + x] = _worldGenerationSystem.getTerrainTypeAt(x * cellSize, y * cellSize);
-        }
+    // Chunk streaming reads the same raster, so the world's noise is only evaluated once.
+    // A null raster means a newer snapshot cancelled the build; cities placed on this one
+    // would not match the world on screen.
+    const auto raster = _worldRaster.acquire(snapshot);
+    if (!raster) {
+        return false;
     }
+    _terrainCache = raster->terrain;
+    return true;
 }
 
 void CityPlacementSystem::calculateWaterSuitability(int mapWidth, int mapHeight, std::vector<float> &map) {
     const int maxDist = Constants::WATER_SUITABILITY_MAX_DISTANCE;
-
-    std::vector<int> dist(mapWidth * mapHeight, -1);
-    std::queue<sf::Vector2i> q;
-
-    for (int y = 0; y < mapHeight; ++y) {
-        for (int x = 0; x < mapWidth; ++x) {
-            if (_terrainCache[y * mapWidth + x] == TerrainType::WATER) {
-                q.push({x, y});
-                dist[y * mapWidth + x] = 0;
+    // Cells further than maxDist from water score nothing, so distances saturate above it.
+    const int beyond = maxDist + 1;
+    const TaskPriority priority = mapPriority();
+
+    // Manhattan distance to the nearest water cell, found along each row and then down and
+    // up each column. Unlike a flood fill from the shore, rows and column strips are
+    // independent of each other.
+    std::vector<int> dist(static_cast<std::size_t>(mapWidth) * mapHeight);
+    Parallel::forRange(
+        _threadPool, 0, mapHeight, rowGrain(mapWidth),
+        [&](int firstRow, int lastRow) {
+            for (int y = firstRow; y < lastRow; ++y) {
+                const std::size_t rowStart = static_cast<std::size_t>(y) * mapWidth;
+                int *row = dist.data() + rowStart;
+                int run = beyond;
+                for (int x = 0; x < mapWidth; ++x) {
+                    run = _terrainCache[rowStart + x] == TerrainType::WATER
+                              ? 0
+                              : std::min(run + 1, beyond);
+                    row[x] = run;
+                }
+                run = beyond;
+                for (int x = mapWidth - 1; x >= 0; --x) {
+                    run = std::min(row[x], run + 1);
+                    row[x] = run;
+                }
             }
-        }
-    }
-
-    int dx[] = {0, 0, 1, -1};
-    int dy[] = {1, -1, 0, 0};
-
-    while (!q.empty()) {
-        sf::Vector2i curr = q.front();
-        q.pop();
-
-        if (dist[curr.y * mapWidth + curr.x] >= maxDist) continue;
-
-        for (int i = 0; i < 4; ++i) {
-            int nx = curr.x + dx[i];
-            int ny = curr.y + dy[i];
-
-            if (nx >= 0 && nx < mapWidth && ny >= 0 && ny < mapHeight && dist[ny * mapWidth + nx] == -1) {
-                dist[ny * mapWidth + nx] = dist[curr.y * mapWidth + curr.x] + 1;
-                q.push({nx, ny});
+        },
+        priority);
+
+    Parallel::forRange(
+        _threadPool, 0, mapWidth, columnGrain(mapHeight),
+        [&](int firstColumn, int lastColumn) {
+            for (int y = 1; y < mapHeight; ++y) {
+                int *row = dist.data() + static_cast<std::size_t>(y) * mapWidth;
+                const int *above = row - mapWidth;
+                for (int x = firstColumn; x < lastColumn; ++x) {
+                    row[x] = std::min(row[x], above[x] + 1);
+                }
             }
-        }
-    }
-
-    for (int i = 0; i < mapWidth * mapHeight; ++i) {
-        if (dist[i] != -1) {
-            map[i] = std::max(0.0f, 1.0f - static_cast<float>(dist[i]) / maxDist);
-        }
-    }
+            for (int y = mapHeight - 2; y >= 0; --y) {
+                int *row = dist.data() + static_cast<std::size_t>(y) * mapWidth;
+                const int *below = row + mapWidth;
+                for (int x = firstColumn; x < lastColumn; ++x) {
+                    row[x] = std::min(row[x], below[x] + 1);
+                }
+            }
+            for (int y = 0; y < mapHeight; ++y) {
+                const std::size_t rowStart = static_cast<std::size_t>(y) * mapWidth;
+                for (int x = firstColumn; x < lastColumn; ++x) {
+                    const int d = dist[rowStart + x];
+                    if (d <= maxDist) {
+                        map[rowStart + x] = std::max(0.0f, 1.0f - static_cast<float>(d) / maxDist);
+                    }
+                }
+            }
+        },
+        priority);
 }
 
 void CityPlacementSystem::calculateExpandabilitySuitability(int mapWidth, int mapHeight, std::vector<float> &map) {
-    const int radius = 20;
-
-    std::vector<int> landMap(mapWidth * mapHeight, 0);
-    for (int y = 0; y < mapHeight; ++y) {
-        for (int x = 0; x < mapWidth; ++x) {
-            if (_terrainCache[y * mapWidth + x] == TerrainType::LAND) {
-                landMap[y * mapWidth + x] = 1;
+    const int radius = Constants::EXPANDABILITY_SUITABILITY_RADIUS;
+    const TaskPriority priority = mapPriority();
+
+    // Summed-area table of land cells: running sums along each row, then accumulated down
+    // each column strip.
+    std::vector<long long> sat(static_cast<std::size_t>(mapWidth) * mapHeight);
+    Parallel::forRange(
+        _threadPool, 0, mapHeight, rowGrain(mapWidth),
+        [&](int firstRow, int lastRow) {
+            for (int y = firstRow; y < lastRow; ++y) {
+                long long rowSum = 0;
+                for (int x = 0; x < mapWidth; ++x) {
+                    if (_terrainCache[y * mapWidth + x] == TerrainType::LAND) {
+                        ++rowSum;
+                    }
+                    sat[y * mapWidth + x] = rowSum;
+                }
             }
-        }
-    }
-
-    std::vector<long long> sat(mapWidth * mapHeight, 0);
-    for (int y = 0; y < mapHeight; ++y) {
-        for (int x = 0; x < mapWidth; ++x) {
-            long long val = landMap[y * mapWidth + x];
-            if (x > 0) val += sat[y * mapWidth + (x - 1)];
-            if (y > 0) val += sat[(y - 1) * mapWidth + x];
-            if (x > 0 && y > 0) val -= sat[(y - 1) * mapWidth + (x - 1)];
-            sat[y * mapWidth + x] = val;
-        }
-    }
-
-    for (int y = 0; y < mapHeight; ++y) {
-        for (int x = 0; x < mapWidth; ++x) {
-            int x1 = std::max(0, x - radius);
-            int y1 = std::max(0, y - radius);
-            int x2 = std::min(mapWidth - 1, x + radius);
-            int y2 = std::min(mapHeight - 1, y + radius);
-
-            long long sum = sat[y2 * mapWidth + x2];
-            if (x1 > 0) sum -= sat[y2 * mapWidth + (x1 - 1)];
-            if (y1 > 0) sum -= sat[(y1 - 1) * mapWidth + x2];
-            if (x1 > 0 && y1 > 0) sum += sat[(y1 - 1) * mapWidth + (x1 - 1)];
-            
-            float area = static_cast<float>((x2 - x1 + 1) * (y2 - y1 + 1));
-            float landRatio = static_cast<float>(sum) / area;
-            map[y * mapWidth + x] = landRatio * landRatio;
-        }
-    }
+        },
+        priority);
+
+    Parallel::forRange(
+        _threadPool, 0, mapWidth, columnGrain(mapHeight),
+        [&](int firstColumn, int lastColumn) {
+            for (int y = 1; y < mapHeight; ++y) {
+                for (int x = firstColumn; x < lastColumn; ++x) {
+                    sat[y * mapWidth + x] += sat[(y - 1) * mapWidth + x];
+                }
+            }
+        },
+        priority);
+
+    Parallel::forRange(
+        _threadPool, 0, mapHeight, rowGrain(mapWidth),
+        [&](int firstRow, int lastRow) {
+            for (int y = firstRow; y < lastRow; ++y) {
+                for (int x = 0; x < mapWidth; ++x) {
+                    int x1 = std::max(0, x - radius);
+                    int y1 = std::max(0, y - radius);
+                    int x2 = std::min(mapWidth - 1, x + radius);
+                    int y2 = std::min(mapHeight - 1, y + radius);
+
+                    long long sum = sat[y2 * mapWidth + x2];
+                    if (x1 > 0) sum -= sat[y2 * mapWidth + (x1 - 1)];
+                    if (y1 > 0) sum -= sat[(y1 - 1) * mapWidth + x2];
+                    if (x1 > 0 && y1 > 0) sum += sat[(y1 - 1) * mapWidth + (x1 - 1)];
+
+                    float area = static_cast<float>((x2 - x1 + 1) * (y2 - y1 + 1));
+                    float landRatio = static_cast<float>(sum) / area;
+                    map[y * mapWidth + x] = landRatio * landRatio;
+                }
+            }
+        },
+        priority);
 }
 
 void CityPlacementSystem::combineSuitabilityMaps(int mapWidth, int mapHeight, const PlacementWeights &weights) {
-    for (int i = 0; i < mapWidth * mapHeight; ++i) {
-        if (_terrainCache[i] != TerrainType::LAND) {
-            _suitabilityMaps.final[i] = 0;
-            _suitabilityMaps.townFinal[i] = 0;
-            _suitabilityMaps.suburbFinal[i] = 0;
-            continue;
-        }
-
-        float baseSuitability = (_suitabilityMaps.water[i] * weights.waterAccess) +
-                                (_suitabilityMaps.expandability[i] * weights.landExpandability) +
-                                (_suitabilityMaps.noise[i] * weights.randomness);
-
-        _suitabilityMaps.final[i] = baseSuitability + (_suitabilityMaps.cityProximity[i] * weights.cityProximity);
-        _suitabilityMaps.townFinal[i] = baseSuitability + (_suitabilityMaps.townProximity[i] * weights.cityProximity);
-        _suitabilityMaps.suburbFinal[i] = baseSuitability + (_suitabilityMaps.suburbProximity[i] * weights.cityProximity);
-    }
+    // The kernel takes land as a float mask, unpacked from the terrain a block at a time.
+    constexpr int blockCells = 1024;
+    const SimdKernels::Table &kernels = SimdKernels::active();
+
+    Parallel::forRange(
+        _threadPool, 0, mapWidth * mapHeight, Constants::SUITABILITY_TILE_CELLS,
+        [&](int first, int last) {
+            float land[blockCells];
+            SimdKernels::SuitabilitySpan span;
+            span.land = land;
+            span.waterWeight = weights.waterAccess;
+            span.expandabilityWeight = weights.landExpandability;
+            span.noiseWeight = weights.randomness;
+            span.proximityWeight = weights.cityProximity;
+
+            for (int blockStart = first; blockStart < last; blockStart += blockCells) {
+                const int count = std::min(blockCells, last - blockStart);
+                for (int i = 0; i < count; ++i) {
+                    land[i] = _terrainCache[blockStart + i] == TerrainType::LAND ? 1.0f : 0.0f;
+                }
+                span.water = _suitabilityMaps.water.data() + blockStart;
+                span.expandability = _suitabilityMaps.expandability.data() + blockStart;
+                span.noise = _suitabilityMaps.noise.data() + blockStart;
+                span.cityProximity = _suitabilityMaps.cityProximity.data() + blockStart;
+                span.townProximity = _suitabilityMaps.townProximity.data() + blockStart;
+                span.suburbProximity = _suitabilityMaps.suburbProximity.data() + blockStart;
+                span.outFinal = _suitabilityMaps.final.data() + blockStart;
+                span.outTown = _suitabilityMaps.townFinal.data() + blockStart;
+                span.outSuburb = _suitabilityMaps.suburbFinal.data() + blockStart;
+                kernels.combineSuitability(span, 0, count);
+            }
+        },
+        mapPriority());
 }
 
 void CityPlacementSystem::normalizeMap(std::vector<float> &map) {
-    float minVal = std::numeric_limits<float>::max();
-    float maxVal = std::numeric_limits<float>::min();
-
-    for (float val : map) {
-        if (val > 0) {
-            minVal = std::min(minVal, val);
-            maxVal = std::max(maxVal, val);
-        }
-    }
+    // The smallest and largest positive values.
+    using ValueRange = std::pair<float, float>;
+    const ValueRange range = Parallel::reduce(
+        _threadPool, 0, static_cast<int>(map.size()), Constants::SUITABILITY_TILE_CELLS,
+        ValueRange{std::numeric_limits<float>::max(), std::numeric_limits<float>::min()},
+        [&map](int first, int last) {
+            ValueRange tile{std::numeric_limits<float>::max(), std::numeric_limits<float>::min()};
+            for (int i = first; i < last; ++i) {
+                if (map[i] > 0) {
+                    tile.first = std::min(tile.first, map[i]);
+                    tile.second = std::max(tile.second, map[i]);
+                }
+            }
+            return tile;
+        },
+        [](ValueRange a, ValueRange b) {
+            return ValueRange{std::min(a.first, b.first), std::max(a.second, b.second)};
+        },
+        mapPriority());
+    const float minVal = range.first;
+    const float maxVal = range.second;
 
     if (maxVal > minVal) {
-        for (float &val : map) {
-            if (val > 0) {
-                val = (val - minVal) / (maxVal - minVal);
-            }
-        }
+        Parallel::forRange(
+            _threadPool, 0, static_cast<int>(map.size()), Constants::SUITABILITY_TILE_CELLS,
+            [&](int first, int last) {
+                for (int i = first; i < last; ++i) {
+                    if (map[i] > 0) {
+                        map[i] = (map[i] - minVal) / (maxVal - minVal);
+                    }
+                }
+            },
+            mapPriority());
     }
 }
 
@@ -574,12 +691,17 @@ sf::Vector2i CityPlacementSystem::findRandomSuitableLocation(int mapWidth, int m
 }
 
 void CityPlacementSystem::calculateNoiseSuitability(int mapWidth, int mapHeight, std::vector<float> &map) {
-    for (int y = 0; y < mapHeight; ++y) {
-        for (int x = 0; x < mapWidth; ++x) {
-            float noiseVal = _noise.GetNoise((float)x, (float)y);
-            map[y * mapWidth + x] = (noiseVal + 1.0f) / 2.0f;
-        }
-    }
+    Parallel::forRange(
+        _threadPool, 0, mapHeight, rowGrain(mapWidth),
+        [&](int firstRow, int lastRow) {
+            for (int y = firstRow; y < lastRow; ++y) {
+                for (int x = 0; x < mapWidth; ++x) {
+                    float noiseVal = _noise.GetNoise((float)x, (float)y);
+                    map[y * mapWidth + x] = (noiseVal + 1.0f) / 2.0f;
+                }
+            }
+        },
+        mapPriority());
 }
 
 sf::Vector2i CityPlacementSystem::findBestLocation(int mapWidth, int mapHeight, const std::vector<float> &suitabilityMap) {
@@ -671,24 +793,50 @@ void CityPlacementSystem::initializeSuitabilityMaps(int mapWidth, int mapHeight)
 }
 
 void CityPlacementSystem::calculateBaseSuitabilityMaps(int mapWidth, int mapHeight) {
-    _loadingState.message = "Assessing water access...";
-    calculateWaterSuitability(mapWidth, mapHeight, _suitabilityMaps.water);
-    normalizeMap(_suitabilityMaps.water);
-    _loadingState.progress = 0.4f;
-
-    _loadingState.message = "Evaluating expansion potential...";
-    calculateExpandabilitySuitability(mapWidth, mapHeight, _suitabilityMaps.expandability);
-    normalizeMap(_suitabilityMaps.expandability);
-    _loadingState.progress = 0.5f;
-
-    _loadingState.message = "Adding environmental noise...";
-    calculateNoiseSuitability(mapWidth, mapHeight, _suitabilityMaps.noise);
-    normalizeMap(_suitabilityMaps.noise);
+    // The three maps are independent; each is normalised as soon as it is done.
+    _loadingState.message = "Assessing water access and expansion potential...";
+    std::atomic<int> mapsDone{0};
+    // Nodes finish in any order, so progress only ever moves forward.
+    auto mapDone = [this, &mapsDone]() {
+        const float target =
+            0.3f + 0.1f * static_cast<float>(mapsDone.fetch_add(1, std::memory_order_relaxed) + 1);
+        float current = _loadingState.progress.load(std::memory_order_relaxed);
+        while (current < target
+               && !_loadingState.progress.compare_exchange_weak(current, target,
+                                                                std::memory_order_relaxed)) {
+        }
+    };
+
+    TaskGraph graph;
+    const TaskGraph::NodeId water = graph.add([this, mapWidth, mapHeight]() {
+        calculateWaterSuitability(mapWidth, mapHeight, _suitabilityMaps.water);
+    });
+    graph.add([this, &mapDone]() {
+        normalizeMap(_suitabilityMaps.water);
+        mapDone();
+    }, {water});
+
+    const TaskGraph::NodeId expandability = graph.add([this, mapWidth, mapHeight]() {
+        calculateExpandabilitySuitability(mapWidth, mapHeight, _suitabilityMaps.expandability);
+    });
+    graph.add([this, &mapDone]() {
+        normalizeMap(_suitabilityMaps.expandability);
+        mapDone();
+    }, {expandability});
+
+    const TaskGraph::NodeId noise = graph.add([this, mapWidth, mapHeight]() {
+        calculateNoiseSuitability(mapWidth, mapHeight, _suitabilityMaps.noise);
+    });
+    graph.add([this, &mapDone]() {
+        normalizeMap(_suitabilityMaps.noise);
+        mapDone();
+    }, {noise});
+
+    graph.run(_threadPool, mapPriority());
     _loadingState.progress = 0.6f;
 }
 
-void CityPlacementSystem::placeInitialCapitals(int mapWidth, int mapHeight) {
-    const float cellSize = _worldGenerationSystem.getParams().cellSize;
+void CityPlacementSystem::placeInitialCapitals(int mapWidth, int mapHeight, float cellSize) {
     const int totalCapitals = std::max(1, Constants::INITIAL_CITY_COUNT);
     const float startProgress = 0.62f;
     const float endProgress = 0.82f;
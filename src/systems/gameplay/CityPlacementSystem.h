@@ -8,6 +8,7 @@
 #include "event/DeletionEvents.h"
 #include "FastNoiseLite.h"
 #include "Constants.h"
+#include "core/TaskTracker.h"
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/Time.hpp>
 #include <vector>
@@ -16,13 +17,18 @@
 #include <future>
 #include <atomic>
 #include <string>
+#include <cstdint>
+#include <memory>
 
 struct LoadingState;
 class WorldGenerationSystem;
+struct WorldGenSnapshot;
+class WorldRaster;
 class EntityFactory;
 class Renderer;
 class PerformanceMonitor;
 class ThreadPool;
+enum class TaskPriority : std::uint8_t;
 
 struct PlacementWeights {
     float waterAccess = Constants::SUITABILITY_WEIGHT_WATER;
@@ -60,7 +66,7 @@ struct CityPlacementSerializedState {
     PlacementWeights weights;
     SuitabilityMaps suitabilityMaps;
     std::vector<PlacedCityInfo> placedCities;
-    std::vector<TerrainType> terrainCache;
+    PackedTerrainCells terrainCache;
     std::vector<int> distanceToNearestCapital;
     std::vector<int> distanceToNearestTown;
     float timeSinceLastCity = 0.0f;
@@ -77,7 +83,7 @@ struct CityPlacementSerializedState {
 
 class CityPlacementSystem : public ISystem, public IUpdatable {
 public:
-    explicit CityPlacementSystem(LoadingState& loadingState, WorldGenerationSystem& worldGenerationSystem, EntityFactory& entityFactory, Renderer& renderer, EventBus& eventBus, PerformanceMonitor& performanceMonitor, ThreadPool& threadPool);
+    explicit CityPlacementSystem(LoadingState& loadingState, WorldGenerationSystem& worldGenerationSystem, WorldRaster& worldRaster, EntityFactory& entityFactory, Renderer& renderer, EventBus& eventBus, PerformanceMonitor& performanceMonitor, ThreadPool& threadPool);
     ~CityPlacementSystem() override;
 
     void init();
@@ -89,13 +95,16 @@ public:
     void applySerializedState(const CityPlacementSerializedState &state);
 
 private:
-    void initialPlacement(bool isRegeneration);
+    // Places on the world published as `snapshot`, taken when the load was started.
+    void initialPlacement(bool isRegeneration, std::shared_ptr<const WorldGenSnapshot> snapshot);
     bool placeNewCity();
     void asyncUpdateMaps(PlacedCityInfo newCity);
     void onRegenerateEntities(const RegenerateEntitiesEvent &event);
     void resetPlacementState();
     
-    void precomputeTerrainCache(int mapWidth, int mapHeight);
+    // Copies the snapshot's terrain out of the world raster. False if the world was
+    // regenerated before its raster was built.
+    bool precomputeTerrainCache(const std::shared_ptr<const WorldGenSnapshot> &snapshot);
 
     sf::Vector2i findBestLocation(int mapWidth, int mapHeight,
                                   const std::vector<float> &suitabilityMap);
@@ -106,7 +115,7 @@ private:
 
     void initializeSuitabilityMaps(int mapWidth, int mapHeight);
     void calculateBaseSuitabilityMaps(int mapWidth, int mapHeight);
-    void placeInitialCapitals(int mapWidth, int mapHeight);
+    void placeInitialCapitals(int mapWidth, int mapHeight, float cellSize);
     void calculateDependentSuitabilityMaps(int mapWidth, int mapHeight);
 
     void calculateWaterSuitability(int mapWidth, int mapHeight, std::vector<float> &map);
@@ -120,9 +129,12 @@ private:
 
     void combineSuitabilityMaps(int mapWidth, int mapHeight, const PlacementWeights &weights);
     void normalizeMap(std::vector<float> &map);
+    // The pool priority the map passes run their tiles at.
+    TaskPriority mapPriority() const;
 
     LoadingState& _loadingState;
     WorldGenerationSystem& _worldGenerationSystem;
+    WorldRaster& _worldRaster;
     EntityFactory& _entityFactory;
     Renderer& _renderer;
     EventBus& _eventBus;
@@ -132,7 +144,7 @@ private:
     PlacementWeights _weights;
     SuitabilityMaps _suitabilityMaps;
     std::vector<PlacedCityInfo> _placedCities;
-    std::vector<TerrainType> _terrainCache;
+    PackedTerrainCells _terrainCache;
     std::vector<int> _distanceToNearestCapital;
     std::vector<int> _distanceToNearestTown;
 
@@ -156,4 +168,7 @@ private:
     entt::scoped_connection _regenerateEntitiesConnection;
     std::future<void> _regenerationTask;
     std::atomic<bool> _isRegenerating{false};
+    // Regeneration and map refresh tasks use the system; the destructor waits for them.
+    TaskTracker _placementTasks;
+    std::atomic<bool> _shuttingDown{false};
 };
@@ -2,7 +2,7 @@
 #include "Logger.h"
 #include "components/LineComponents.h"
 #include "SnapHelper.h"
-#include "systems/world/WorldGenerationSystem.h"
+#include "world/TerrainQueryService.h"
 #include "ecs/EntityFactory.h"
 #include "render/ColorManager.h"
 #include "imgui.h"
@@ -11,7 +11,6 @@
 #include "event/LineEvents.h"
 
 #include <algorithm>
-#include <array>
 #include <chrono>
 #include <cmath>
 #include <limits>
@@ -19,9 +18,9 @@
 #include <random>
 #include <vector>
 
-LineCreationSystem::LineCreationSystem(entt::registry& registry, EntityFactory& entityFactory, ColorManager& colorManager, GameState& gameState, EventBus& eventBus, WorldGenerationSystem& worldGenerationSystem)
+LineCreationSystem::LineCreationSystem(entt::registry& registry, EntityFactory& entityFactory, ColorManager& colorManager, GameState& gameState, EventBus& eventBus, TerrainQueryService& terrainQuery)
     : _registry(registry), _entityFactory(entityFactory),
-      _colorManager(colorManager), _gameState(gameState), _eventBus(eventBus), _worldGenerationSystem(worldGenerationSystem) {
+      _colorManager(colorManager), _gameState(gameState), _eventBus(eventBus), _terrainQuery(terrainQuery) {
 
     m_finalizeLineConnection = _eventBus.sink<FinalizeLineEvent>()
                                    .connect<&LineCreationSystem::onFinalizeLine>(this);
@@ -124,7 +123,7 @@ void LineCreationSystem::onMouseButtonPressed(const MouseButtonPressedEvent &eve
 }
 
 void LineCreationSystem::addPointToLine(const sf::Vector2f& position, entt::entity stationEntity, std::optional<SnapInfo> snapInfo, float snapSide) {
-    if (_worldGenerationSystem.getTerrainTypeAt(position.x, position.y) == TerrainType::WATER) {
+    if (_terrainQuery.sampleAt(position).terrain == TerrainType::WATER) {
         LOG_WARN("LineCreationSystem", "Cannot place a line point on water.");
         return;
     }
@@ -175,44 +174,34 @@ LineCreationSystem::validateStraightSegment(const sf::Vector2f &from, const sf::
     SegmentValidationResult result;
     const bool enforceGradeLimit = _gameState.elevationChecksEnabled;
 
-    std::array<sf::Vector2f, SEGMENT_INTERIOR_SAMPLES + 2> samples{};
-    samples[0] = from;
-    samples[SEGMENT_INTERIOR_SAMPLES + 1] = to;
-    for (int i = 1; i <= SEGMENT_INTERIOR_SAMPLES; ++i) {
-        float t = static_cast<float>(i) / static_cast<float>(SEGMENT_INTERIOR_SAMPLES + 1);
-        samples[i] = from + (to - from) * t;
-    }
-
-    for (int i = 1; i <= SEGMENT_INTERIOR_SAMPLES; ++i) {
-        const auto &point = samples[i];
-        if (_worldGenerationSystem.getTerrainTypeAt(point.x, point.y) == TerrainType::WATER) {
-            result.crossesWater = true;
-            break;
-        }
-    }
-
-    const float epsilon = std::numeric_limits<float>::epsilon();
-    for (int i = 0; i <= SEGMENT_INTERIOR_SAMPLES; ++i) {
-        const auto &start = samples[i];
-        const auto &end = samples[i + 1];
-        const sf::Vector2f delta = end - start;
-        float distance = std::hypot(delta.x, delta.y);
-        if (distance <= epsilon) {
-            continue;
-        }
-        float elevationStart = _worldGenerationSystem.getElevationAt(start.x, start.y);
-        float elevationEnd = _worldGenerationSystem.getElevationAt(end.x, end.y);
-        float grade = std::abs(elevationEnd - elevationStart) / distance;
-        if (grade > result.maxGrade) {
-            result.maxGrade = grade;
-        }
-        if (grade > MAX_ALLOWED_GRADE) {
-            result.exceedsGrade = true;
-            if (enforceGradeLimit) {
-                break;
+    // Every cell the segment crosses is checked. The endpoint cells are exempt from the
+    // water test, as points are validated when placed; grades are measured between
+    // neighbouring cells.
+    const float cellSize = _terrainQuery.getCellSize();
+    int visitedCells = 0;
+    bool previousIsWater = false;
+    float previousElevation = 0.0f;
+    _terrainQuery.forEachCellOnSegment(
+        from, to, [&](const sf::Vector2i &, const TerrainQueryService::Sample &sample) {
+            if (visitedCells > 0) {
+                // The previous cell is now known not to be the last one.
+                if (visitedCells > 1 && previousIsWater) {
+                    result.crossesWater = true;
+                }
+                float grade = std::abs(sample.elevation - previousElevation) / cellSize;
+                if (grade > result.maxGrade) {
+                    result.maxGrade = grade;
+                }
+                if (grade > MAX_ALLOWED_GRADE) {
+                    result.exceedsGrade = true;
+                }
             }
-        }
-    }
+            ++visitedCells;
+            previousIsWater = sample.terrain == TerrainType::WATER;
+            previousElevation = sample.elevation;
+            // Stop once the grade alone rejects the segment.
+            return !(result.exceedsGrade && enforceGradeLimit);
+        });
 
     const bool gradeViolation = enforceGradeLimit && result.exceedsGrade;
     result.isValid = !result.crossesWater && !gradeViolation;
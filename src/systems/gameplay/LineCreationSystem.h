@@ -14,7 +14,7 @@
 
 class EntityFactory;
 class ColorManager;
-class WorldGenerationSystem;
+class TerrainQueryService;
 
 struct ActiveLine {
     std::vector<LinePoint> points;
@@ -35,7 +35,7 @@ struct LinePreview {
 
 class LineCreationSystem : public ISystem, public IUpdatable {
 public:
-    explicit LineCreationSystem(entt::registry& registry, EntityFactory& entityFactory, ColorManager& colorManager, GameState& gameState, EventBus& eventBus, WorldGenerationSystem& worldGenerationSystem);
+    explicit LineCreationSystem(entt::registry& registry, EntityFactory& entityFactory, ColorManager& colorManager, GameState& gameState, EventBus& eventBus, TerrainQueryService& terrainQuery);
     ~LineCreationSystem();
 
     void update(sf::Time dt) override;
@@ -64,7 +64,7 @@ private:
     ColorManager &_colorManager;
     GameState &_gameState;
     EventBus& _eventBus;
-    WorldGenerationSystem& _worldGenerationSystem;
+    TerrainQueryService& _terrainQuery;
     sf::Vector2f _currentMouseWorldPos;
 
     entt::scoped_connection m_finalizeLineConnection;
@@ -73,5 +73,4 @@ private:
     entt::scoped_connection m_mouseMoveConnection;
 
     static constexpr float MAX_ALLOWED_GRADE = 0.05f;
-    static constexpr int SEGMENT_INTERIOR_SAMPLES = 4;
 };
@@ -1,12 +1,37 @@
 #include "TerrainRenderSystem.h"
 #include "components/RenderComponents.h"
 #include "components/WorldComponents.h"
+#include "world/SimdKernels.h"
 #include "world/WorldData.h"
 #include "systems/gameplay/CityPlacementSystem.h"
 #include "Logger.h"
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <vector>
+
+namespace {
+
+sf::Vector3f reliefLightDirection() {
+    sf::Vector3f lightDir(-0.5f, -0.7f, 1.0f);
+    const float lightLength = std::sqrt(lightDir.x * lightDir.x + lightDir.y * lightDir.y
+                                        + lightDir.z * lightDir.z);
+    if (lightLength > 0.0f) {
+        lightDir.x /= lightLength;
+        lightDir.y /= lightLength;
+        lightDir.z /= lightLength;
+    }
+    return lightDir;
+}
+
+float reliefLightingFactor(const sf::Vector3f &normal, const sf::Vector3f &lightDir,
+                           float normalizedElevation) {
+    const float diffuse =
+        std::max(0.0f, normal.x * lightDir.x + normal.y * lightDir.y + normal.z * lightDir.z);
+    return std::clamp(0.35f + 0.55f * diffuse + 0.25f * normalizedElevation, 0.25f, 1.3f);
+}
+
+}  // namespace
 
 TerrainRenderSystem::TerrainRenderSystem(ColorManager &colorManager)
     : _colorManager(colorManager) {}
@@ -40,12 +65,23 @@ void TerrainRenderSystem::render(const entt::registry &registry, sf::RenderTarge
     viewBounds.size.x += worldParams.cellSize * 2;
     viewBounds.size.y += worldParams.cellSize * 2;
 
+    // While the chunk manager switches LOD levels both levels are loaded; draw coarser
+    // chunks first so finer ones land on top.
+    _drawOrder.clear();
     for (auto entity : chunkView) {
+        _drawOrder.emplace_back(chunkView.get<const ChunkPositionComponent>(entity).lodLevel,
+                                entity);
+    }
+    std::stable_sort(_drawOrder.begin(), _drawOrder.end(),
+                     [](const auto &lhs, const auto &rhs) { return lhs.first > rhs.first; });
+
+    for (const auto &[lodLevel, entity] : _drawOrder) {
         const auto &chunkPos = chunkView.get<const ChunkPositionComponent>(entity);
         const auto &chunkMesh = chunkView.get<const ChunkMeshComponent>(entity);
 
-        float chunkWidthPixels = worldParams.chunkDimensionsInCells.x * worldParams.cellSize;
-        float chunkHeightPixels = worldParams.chunkDimensionsInCells.y * worldParams.cellSize;
+        const float cellSize = worldParams.cellSize * static_cast<float>(1 << lodLevel);
+        float chunkWidthPixels = worldParams.chunkDimensionsInCells.x * cellSize;
+        float chunkHeightPixels = worldParams.chunkDimensionsInCells.y * cellSize;
         sf::FloatRect chunkBounds({chunkPos.chunkGridPosition.x * chunkWidthPixels,
                                    chunkPos.chunkGridPosition.y * chunkHeightPixels},
                                   {chunkWidthPixels, chunkHeightPixels});
@@ -86,12 +122,12 @@ void TerrainRenderSystem::render(const entt::registry &registry, sf::RenderTarge
             sf::Color gridColor(128, 128, 128, 128);
 
             for (unsigned int i = 1; i < worldParams.chunkDimensionsInCells.x; ++i) {
-                float x = chunkLeft + i * worldParams.cellSize;
+                float x = chunkLeft + i * cellSize;
                 gridLines.append({{x, chunkTop}, gridColor});
                 gridLines.append({{x, chunkBottom}, gridColor});
             }
             for (unsigned int i = 1; i < worldParams.chunkDimensionsInCells.y; ++i) {
-                float y = chunkTop + i * worldParams.cellSize;
+                float y = chunkTop + i * cellSize;
                 gridLines.append({{chunkLeft, y}, gridColor});
                 gridLines.append({{chunkRight, y}, gridColor});
             }
@@ -118,7 +154,13 @@ void TerrainRenderSystem::buildAllChunkMeshes(const ChunkPositionComponent &chun
                                               const ChunkElevationComponent &chunkElevation,
                                               ChunkMeshComponent &chunkMesh,
                                               const WorldGenParams &worldParams) {
-    if (_shadedReliefEnabled) {
+    // A chunk of one terrain type draws as a single quad; shading also needs one elevation,
+    // which leaves every cell with the same flat normal.
+    const bool isUniform = chunkTerrain.cells.isUniform()
+                           && (!_shadedReliefEnabled || chunkElevation.elevations.isUniform());
+    if (isUniform) {
+        buildChunkMeshUniform(chunkPos, chunkTerrain, chunkElevation, chunkMesh, worldParams);
+    } else if (_shadedReliefEnabled) {
         buildChunkMeshShaded(chunkPos, chunkTerrain, chunkElevation, chunkMesh, worldParams);
     } else {
         buildChunkMeshMerged(chunkPos, chunkTerrain, chunkMesh, worldParams);
@@ -131,6 +173,7 @@ void TerrainRenderSystem::buildChunkMeshMerged(const ChunkPositionComponent &chu
                                                const WorldGenParams &worldParams) {
     const int cellsX = worldParams.chunkDimensionsInCells.x;
     const int cellsY = worldParams.chunkDimensionsInCells.y;
+    const float cellSize = worldParams.cellSize * static_cast<float>(1 << chunkPos.lodLevel);
 
     sf::VertexArray &vertexArray = chunkMesh.vertexArray;
     vertexArray.clear();
@@ -179,10 +222,10 @@ void TerrainRenderSystem::buildChunkMeshMerged(const ChunkPositionComponent &chu
                 }
             }
 
-            const float screenX = (chunkPos.chunkGridPosition.x * cellsX + x) * worldParams.cellSize;
-            const float screenY = (chunkPos.chunkGridPosition.y * cellsY + y) * worldParams.cellSize;
-            const float quadWidth = static_cast<float>(rectWidth) * worldParams.cellSize;
-            const float quadHeight = static_cast<float>(rectHeight) * worldParams.cellSize;
+            const float screenX = (chunkPos.chunkGridPosition.x * cellsX + x) * cellSize;
+            const float screenY = (chunkPos.chunkGridPosition.y * cellsY + y) * cellSize;
+            const float quadWidth = static_cast<float>(rectWidth) * cellSize;
+            const float quadHeight = static_cast<float>(rectHeight) * cellSize;
 
             sf::Vertex quad[6];
             quad[0].position = {screenX, screenY};
@@ -192,21 +235,7 @@ void TerrainRenderSystem::buildChunkMeshMerged(const ChunkPositionComponent &chu
             quad[4].position = {screenX + quadWidth, screenY + quadHeight};
             quad[5].position = {screenX, screenY + quadHeight};
 
-            sf::Color color;
-            switch (currentType) {
-            case TerrainType::WATER:
-                color = _colorManager.getWaterColor();
-                break;
-            case TerrainType::LAND:
-                color = _colorManager.getLandColor();
-                break;
-            case TerrainType::RIVER:
-                color = _colorManager.getRiverColor();
-                break;
-            default:
-                color = sf::Color::Magenta;
-                break;
-            }
+            const sf::Color color = baseColorForTerrain(currentType);
 
             for (auto &vertex : quad) {
                 vertex.color = color;
@@ -227,71 +256,58 @@ void TerrainRenderSystem::buildChunkMeshShaded(const ChunkPositionComponent &chu
     sf::VertexArray &vertexArray = chunkMesh.vertexArray;
     vertexArray.clear();
     vertexArray.setPrimitiveType(sf::PrimitiveType::Triangles);
+    if (cellsX <= 0 || cellsY <= 0) {
+        return;
+    }
 
-    const std::vector<float> &elevations = chunkElevation.elevations;
-    auto elevationAt = [&](int cellX, int cellY, float fallback) -> float {
-        if (cellX < 0 || cellY < 0 || cellX >= cellsX || cellY >= cellsY) {
-            return fallback;
-        }
-        const size_t index = static_cast<size_t>(cellY * cellsX + cellX);
-        if (index < elevations.size()) {
-            return elevations[index];
-        }
-        return fallback;
-    };
-
+    const ChunkCellsView cells{chunkTerrain.cells, chunkElevation.elevations, cellsX, cellsY};
     const float maxElevation = std::max(0.0001f, worldParams.elevation.maxElevation);
-    const float cellSize = worldParams.cellSize;
-
-    sf::Vector3f lightDir(-0.5f, -0.7f, 1.0f);
-    const float lightLength = std::sqrt(lightDir.x * lightDir.x + lightDir.y * lightDir.y
-                                        + lightDir.z * lightDir.z);
-    if (lightLength > 0.0f) {
-        lightDir.x /= lightLength;
-        lightDir.y /= lightLength;
-        lightDir.z /= lightLength;
+    const float cellSize = worldParams.cellSize * static_cast<float>(1 << chunkPos.lodLevel);
+    const sf::Vector3f lightDir = reliefLightDirection();
+
+    // Elevations with a one-cell border copied from the edge cells, so a cell on the chunk's
+    // edge sees itself as its missing neighbour and the lighting kernel needs no edge cases.
+    const int paddedWidth = cellsX + 2;
+    std::vector<float> padded(static_cast<std::size_t>(paddedWidth) * (cellsY + 2), 0.0f);
+    auto paddedRow = [&](int y) {
+        return padded.data() + static_cast<std::size_t>(y + 1) * paddedWidth + 1;
+    };
+    for (int y = 0; y < cellsY; ++y) {
+        float *row = paddedRow(y);
+        for (int x = 0; x < cellsX; ++x) {
+            row[x] = cells.contains(x, y) ? cells.elevationAt(x, y) : 0.0f;
+        }
+        row[-1] = row[0];
+        row[cellsX] = row[cellsX - 1];
     }
+    std::copy_n(paddedRow(0) - 1, paddedWidth, paddedRow(-1) - 1);
+    std::copy_n(paddedRow(cellsY - 1) - 1, paddedWidth, paddedRow(cellsY) - 1);
+
+    std::vector<float> lighting(static_cast<std::size_t>(cellsX));
+    std::vector<float> normalized(static_cast<std::size_t>(cellsX));
+    const SimdKernels::Table &kernels = SimdKernels::active();
+    SimdKernels::ReliefRow relief;
+    relief.twoCellSize = 2.0f * cellSize;
+    relief.maxElevation = maxElevation;
+    relief.lightX = lightDir.x;
+    relief.lightY = lightDir.y;
+    relief.lightZ = lightDir.z;
+    relief.outLighting = lighting.data();
+    relief.outNormalizedElevation = normalized.data();
 
     for (int y = 0; y < cellsY; ++y) {
+        relief.up = paddedRow(y - 1);
+        relief.center = paddedRow(y);
+        relief.down = paddedRow(y + 1);
+        kernels.reliefLighting(relief, 0, cellsX);
+
         for (int x = 0; x < cellsX; ++x) {
-            const size_t cellIndex = static_cast<size_t>(y * cellsX + x);
             const TerrainType terrainType =
-                (cellIndex < chunkTerrain.cells.size()) ? chunkTerrain.cells[cellIndex]
-                                                        : TerrainType::WATER;
-            const float centerElevation =
-                (cellIndex < elevations.size()) ? elevations[cellIndex] : 0.0f;
-            float normalizedElevation = centerElevation / maxElevation;
-            normalizedElevation = std::clamp(normalizedElevation, 0.0f, 1.0f);
-
-            const float leftElevation = elevationAt(x - 1, y, centerElevation);
-            const float rightElevation = elevationAt(x + 1, y, centerElevation);
-            const float upElevation = elevationAt(x, y - 1, centerElevation);
-            const float downElevation = elevationAt(x, y + 1, centerElevation);
-
-            const float dx = (rightElevation - leftElevation) / (2.0f * cellSize);
-            const float dy = (downElevation - upElevation) / (2.0f * cellSize);
-
-            sf::Vector3f normal(-dx, -dy, 1.0f);
-            const float normalLength = std::sqrt(normal.x * normal.x + normal.y * normal.y
-                                                 + normal.z * normal.z);
-            if (normalLength > 0.0f) {
-                normal.x /= normalLength;
-                normal.y /= normalLength;
-                normal.z /= normalLength;
-            }
-
-            const float diffuse =
-                std::max(0.0f, normal.x * lightDir.x + normal.y * lightDir.y + normal.z * lightDir.z);
-            float lightingFactor = 0.35f + 0.55f * diffuse + 0.25f * normalizedElevation;
-            lightingFactor = std::clamp(lightingFactor, 0.25f, 1.3f);
+                cells.contains(x, y) ? cells.terrainAt(x, y) : TerrainType::WATER;
+            const sf::Color color = shadeColorForTerrain(terrainType, normalized[x], lighting[x]);
 
-            const sf::Color color =
-                shadeColorForTerrain(terrainType, normalizedElevation, lightingFactor);
-
-            const float screenX =
-                (chunkPos.chunkGridPosition.x * cellsX + x) * worldParams.cellSize;
-            const float screenY =
-                (chunkPos.chunkGridPosition.y * cellsY + y) * worldParams.cellSize;
+            const float screenX = (chunkPos.chunkGridPosition.x * cellsX + x) * cellSize;
+            const float screenY = (chunkPos.chunkGridPosition.y * cellsY + y) * cellSize;
 
             sf::Vertex quad[6];
             quad[0].position = {screenX, screenY};
@@ -309,23 +325,74 @@ void TerrainRenderSystem::buildChunkMeshShaded(const ChunkPositionComponent &chu
     }
 }
 
-sf::Color TerrainRenderSystem::shadeColorForTerrain(TerrainType type, float normalizedElevation,
-                                                    float lightingFactor) const {
-    sf::Color baseColor;
+void TerrainRenderSystem::buildChunkMeshUniform(const ChunkPositionComponent &chunkPos,
+                                                const ChunkTerrainComponent &chunkTerrain,
+                                                const ChunkElevationComponent &chunkElevation,
+                                                ChunkMeshComponent &chunkMesh,
+                                                const WorldGenParams &worldParams) {
+    const int cellsX = worldParams.chunkDimensionsInCells.x;
+    const int cellsY = worldParams.chunkDimensionsInCells.y;
+    const float cellSize = worldParams.cellSize * static_cast<float>(1 << chunkPos.lodLevel);
+
+    sf::VertexArray &vertexArray = chunkMesh.vertexArray;
+    vertexArray.clear();
+    vertexArray.setPrimitiveType(sf::PrimitiveType::Triangles);
+
+    const TerrainType terrainType =
+        chunkTerrain.cells.empty() ? TerrainType::WATER : chunkTerrain.cells[0];
+    sf::Color color = baseColorForTerrain(terrainType);
+    if (_shadedReliefEnabled) {
+        const float maxElevation = std::max(0.0001f, worldParams.elevation.maxElevation);
+        const float elevation =
+            chunkElevation.elevations.empty() ? 0.0f : chunkElevation.elevations[0];
+        const float normalizedElevation = std::clamp(elevation / maxElevation, 0.0f, 1.0f);
+        const float lightingFactor = reliefLightingFactor(
+            sf::Vector3f(0.0f, 0.0f, 1.0f), reliefLightDirection(), normalizedElevation);
+        color = shadeColorForTerrain(terrainType, normalizedElevation, lightingFactor);
+    }
+
+    const float screenX = static_cast<float>(chunkPos.chunkGridPosition.x * cellsX) * cellSize;
+    const float screenY = static_cast<float>(chunkPos.chunkGridPosition.y * cellsY) * cellSize;
+    const float quadWidth = static_cast<float>(cellsX) * cellSize;
+    const float quadHeight = static_cast<float>(cellsY) * cellSize;
+
+    sf::Vertex quad[6];
+    quad[0].position = {screenX, screenY};
+    quad[1].position = {screenX + quadWidth, screenY};
+    quad[2].position = {screenX, screenY + quadHeight};
+    quad[3].position = {screenX + quadWidth, screenY};
+    quad[4].position = {screenX + quadWidth, screenY + quadHeight};
+    quad[5].position = {screenX, screenY + quadHeight};
+
+    for (auto &vertex : quad) {
+        vertex.color = color;
+        vertexArray.append(vertex);
+    }
+}
+
+sf::Color TerrainRenderSystem::previewColor(TerrainType type, float normalizedElevation) const {
+    static const sf::Vector3f lightDir = reliefLightDirection();
+    const float lightingFactor =
+        reliefLightingFactor(sf::Vector3f(0.0f, 0.0f, 1.0f), lightDir, normalizedElevation);
+    return shadeColorForTerrain(type, normalizedElevation, lightingFactor);
+}
+
+sf::Color TerrainRenderSystem::baseColorForTerrain(TerrainType type) const {
     switch (type) {
     case TerrainType::WATER:
-        baseColor = _colorManager.getWaterColor();
-        break;
+        return _colorManager.getWaterColor();
     case TerrainType::LAND:
-        baseColor = _colorManager.getLandColor();
-        break;
+        return _colorManager.getLandColor();
     case TerrainType::RIVER:
-        baseColor = _colorManager.getRiverColor();
-        break;
+        return _colorManager.getRiverColor();
     default:
-        baseColor = sf::Color::Magenta;
-        break;
+        return sf::Color::Magenta;
     }
+}
+
+sf::Color TerrainRenderSystem::shadeColorForTerrain(TerrainType type, float normalizedElevation,
+                                                    float lightingFactor) const {
+    const sf::Color baseColor = baseColorForTerrain(type);
 
     float factor = lightingFactor;
     if (type == TerrainType::LAND) {
@@ -346,7 +413,7 @@ sf::Color TerrainRenderSystem::shadeColorForTerrain(TerrainType type, float norm
             baseColor.a};
 }
 
-void TerrainRenderSystem::setSuitabilityMapData(const SuitabilityMaps* maps, const std::vector<TerrainType>* terrainCache, const WorldGenParams& worldParams) {
+void TerrainRenderSystem::setSuitabilityMapData(const SuitabilityMaps* maps, const PackedTerrainCells* terrainCache, const WorldGenParams& worldParams) {
     _suitabilityMaps = maps;
     _terrainCache = terrainCache;
     _suitabilityMapsDirty = true;
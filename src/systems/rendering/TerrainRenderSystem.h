@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <utility>
 #include "render/ColorManager.h"
 
 struct ChunkPositionComponent;
@@ -14,6 +15,7 @@ struct ChunkMeshComponent;
 struct WorldGenParams;
 struct SuitabilityMaps;
 enum class TerrainType;
+class PackedTerrainCells;
 
 class TerrainRenderSystem {
 public:
@@ -36,13 +38,16 @@ public:
     void setVisualizeChunkBorders(bool visualize) noexcept { _visualizeChunkBorders = visualize; }
     void setVisualizeCellBorders(bool visualize) noexcept { _visualizeCellBorders = visualize; }
     void setVisualizeSuitabilityMap(bool visualize) noexcept { _visualizeSuitabilityMap = visualize; }
-    void setSuitabilityMapData(const SuitabilityMaps *maps, const std::vector<TerrainType> *terrainCache, const WorldGenParams &worldParams);
+    void setSuitabilityMapData(const SuitabilityMaps *maps, const PackedTerrainCells *terrainCache, const WorldGenParams &worldParams);
     void setSuitabilityMapType(SuitabilityMapType type) { _suitabilityMapType = type; }
     void setSuitabilityMapsDirty() { _suitabilityMapsDirty = true; }
     void regenerateSuitabilityMaps(const WorldGenParams &worldParams);
     void setShadedReliefEnabled(bool enabled) noexcept { _shadedReliefEnabled = enabled; }
     bool isShadedReliefEnabled() const noexcept { return _shadedReliefEnabled; }
 
+    // Shaded-relief colour of flat ground of `type` at `normalizedElevation`, for previews.
+    sf::Color previewColor(TerrainType type, float normalizedElevation) const;
+
 private:
     ColorManager &_colorManager;
     sf::RectangleShape _cellShape;
@@ -51,9 +56,10 @@ private:
     bool _visualizeSuitabilityMap = false;
     bool _shadedReliefEnabled = false;
     const SuitabilityMaps *_suitabilityMaps = nullptr;
-    const std::vector<TerrainType> *_terrainCache = nullptr;
+    const PackedTerrainCells *_terrainCache = nullptr;
     SuitabilityMapType _suitabilityMapType = SuitabilityMapType::None;
     std::vector<bool> m_visited;
+    std::vector<std::pair<int, entt::entity>> _drawOrder;
     std::map<SuitabilityMapType, std::unique_ptr<sf::RenderTexture>> _suitabilityMapTextures;
     bool _suitabilityMapsDirty = true;
 
@@ -68,6 +74,11 @@ private:
                               const ChunkTerrainComponent &chunkTerrain,
                               const ChunkElevationComponent &chunkElevation,
                               ChunkMeshComponent &chunkMesh, const WorldGenParams &worldParams);
+    void buildChunkMeshUniform(const ChunkPositionComponent &chunkPos,
+                               const ChunkTerrainComponent &chunkTerrain,
+                               const ChunkElevationComponent &chunkElevation,
+                               ChunkMeshComponent &chunkMesh, const WorldGenParams &worldParams);
+    sf::Color baseColorForTerrain(TerrainType type) const;
     sf::Color shadeColorForTerrain(TerrainType type, float normalizedElevation,
                                    float lightingFactor) const;
 };
@@ -1,281 +1,727 @@
 #include "ChunkManagerSystem.h"
+#include "Constants.h"
 #include "Logger.h"
 #include "components/RenderComponents.h"
 #include "components/WorldComponents.h"
 #include "render/Camera.h"
 #include "core/ThreadPool.h"
+#include "world/WorldRaster.h"
 #include <algorithm>
-#include <chrono>
 #include <cmath>
 
-ChunkManagerSystem::ChunkManagerSystem(entt::registry& registry, EventBus& eventBus, WorldGenerationSystem& worldGenSystem, Camera& camera, ThreadPool& threadPool)
-    : _registry(registry), _eventBus(eventBus), _worldGenSystem(worldGenSystem), _camera(camera), _threadPool(threadPool), _activeChunks() {
+ChunkManagerSystem::ChunkManagerSystem(entt::registry& registry, EventBus& eventBus, WorldGenerationSystem& worldGenSystem, WorldRaster& worldRaster, Camera& camera, ThreadPool& threadPool)
+    : _registry(registry), _eventBus(eventBus), _worldGenSystem(worldGenSystem), _worldRaster(worldRaster), _camera(camera), _threadPool(threadPool),
+      _diskCache(std::make_shared<ChunkDiskCache>(
+          ChunkDiskCache::userCacheDirectory() / Constants::CHUNK_CACHE_DIRECTORY,
+          Constants::CHUNK_CACHE_BUDGET_BYTES)),
+      _retentionCache(Constants::CHUNK_RETENTION_BUDGET_BYTES) {
     _regenerateWorldListener = _eventBus.sink<RegenerateWorldRequestEvent>()
                                    .connect<&ChunkManagerSystem::onRegenerateWorld>(this);
-    _swapWorldStateListener =
-        _eventBus.sink<SwapWorldStateEvent>().connect<&ChunkManagerSystem::onSwapWorldState>(this);
     _immediateRedrawListener =
         _eventBus.sink<ImmediateRedrawEvent>().connect<&ChunkManagerSystem::onImmediateRedraw>(
             this);
+    _themeChangedListener =
+        _eventBus.sink<ThemeChangedEvent>().connect<&ChunkManagerSystem::onThemeChanged>(this);
 
     auto entity = _registry.create();
     auto &worldState = _registry.emplace<WorldStateComponent>(entity);
     worldState.activeParams = _worldGenSystem.getParams();
     worldState.generatingParams = worldState.activeParams;
     worldState.pendingParams = worldState.activeParams;
+    adoptSnapshot(_worldGenSystem.getSnapshot());
 }
 
 ChunkManagerSystem::~ChunkManagerSystem() {
+    // Queued lookup and generation tasks return early once they see this and running ones
+    // stop at their next noise field, so the wait is short. Write-backs own their share of
+    // the disk cache and finish on their own.
+    _generationToken.cancel();
+    _chunkTasks.wait();
     _eventBus.sink<RegenerateWorldRequestEvent>().disconnect(this);
-    _eventBus.sink<SwapWorldStateEvent>().disconnect(this);
     _eventBus.sink<ImmediateRedrawEvent>().disconnect(this);
+    _eventBus.sink<ThemeChangedEvent>().disconnect(this);
 }
 
 void ChunkManagerSystem::onImmediateRedraw(const ImmediateRedrawEvent &event) {
-    for (auto const &[pos, entity] : _activeChunks) {
-        if (_registry.valid(entity)) {
-            auto &chunk = _registry.get<ChunkStateComponent>(entity);
-            chunk.isMeshDirty = true;
-        }
+    auto view = _registry.view<ChunkStateComponent>();
+    for (auto entity : view) {
+        view.get<ChunkStateComponent>(entity).isMeshDirty = true;
     }
+    _retentionCache.invalidateMeshes();
+}
+
+void ChunkManagerSystem::onThemeChanged(const ThemeChangedEvent &event) {
+    // Active chunks are rebuilt by TerrainMeshSystem; retained meshes are rebuilt on restore.
+    _retentionCache.invalidateMeshes();
 }
 
 void ChunkManagerSystem::onRegenerateWorld(const RegenerateWorldRequestEvent &event) {
-    if (_generationFuture.valid()) {
-        LOG_WARN("ChunkManagerSystem", "Regeneration requested while a previous generation is still running.");
-        return;
+    if (_pendingRegeneration) {
+        LOG_DEBUG("ChunkManagerSystem", "Superseding a pending world regeneration request.");
     }
+    _pendingRegeneration = event.params;
+    _regenerationDelay = Constants::WORLD_REGENERATION_DEBOUNCE_S;
+}
 
-    WorldGenParams params = *event.params;
-
+void ChunkManagerSystem::applyRegeneration(const WorldGenParams &params) {
     LOG_INFO("ChunkManagerSystem",
              "Starting world regeneration for %d x %d chunks.",
              params.worldDimensionsInChunks.x, params.worldDimensionsInChunks.y);
     auto &worldState =
         _registry.get<WorldStateComponent>(_registry.view<WorldStateComponent>().front());
 
-    const bool hasActiveChunks = !_activeChunks.empty();
+    const bool hasActiveChunks = _activeChunkCount > 0;
     const bool needsFullReload = !hasActiveChunks
                                  || requiresFullReload(worldState.activeParams, params);
 
+    // Publishing a snapshot only reconfigures the noise generators, so it is done inline.
+    // Work still running against the previous snapshot is cancelled on adoption and stops
+    // at its next noise field.
+    _worldGenSystem.regenerate(params);
+    adoptSnapshot(_worldGenSystem.getSnapshot());
+
+    worldState.activeParams = params;
     worldState.generatingParams = params;
     worldState.pendingParams = params;
 
     if (needsFullReload) {
-        _performingFullReload = true;
-        _smoothRegenPending = false;
-        _generationFuture = std::async(std::launch::async, [&, params]() { _worldGenSystem.regenerate(params); });
+        applyFullReload();
         return;
     }
 
     LOG_DEBUG("ChunkManagerSystem", "Applying smooth regeneration (params update without structural changes).");
+    startSmoothRegeneration(params);
+}
 
-    if (!_pendingChunkUpdates.empty()) {
-        _smoothRegenPending = true;
-        LOG_DEBUG("ChunkManagerSystem", "Smooth regeneration already running. Queuing new parameters.");
-        return;
-    }
+void ChunkManagerSystem::adoptSnapshot(std::shared_ptr<const WorldGenSnapshot> snapshot) {
+    // Every chunk request's token is a child of this one.
+    _generationToken.cancel();
+    _generationToken = CancellationToken::create();
+    _worldRaster.cancelBuildsBefore(snapshot->generationId);
+    _retentionCache.clear();
+    _currentGenerationId = snapshot->generationId;
+    _cacheFingerprint = ChunkDiskCache::fingerprint(*snapshot);
+    _snapshot = std::move(snapshot);
+    resetChunkIndex();
+}
 
-    worldState.activeParams = params;
-    _worldGenSystem.regenerate(params);
-    startSmoothRegeneration(params);
-    _smoothRegenPending = false;
+void ChunkManagerSystem::applyFullReload() {
+    destroyAllChunks();
+    resetChunkIndex();
 }
 
-void ChunkManagerSystem::onSwapWorldState(const SwapWorldStateEvent &event) {
-    if (!_performingFullReload) {
-        return;
+void ChunkManagerSystem::update(sf::Time dt) {
+    if (_pendingRegeneration) {
+        _regenerationDelay -= dt.asSeconds();
+        if (_regenerationDelay <= 0.0f) {
+            auto params = std::move(_pendingRegeneration);
+            _pendingRegeneration.reset();
+            applyRegeneration(*params);
+        }
     }
 
-    auto &worldState =
-        _registry.get<WorldStateComponent>(_registry.view<WorldStateComponent>().front());
+    // Params replaced outside a regenerate request (e.g. by loading a save) still publish
+    // a snapshot; pick it up and rebuild the visible chunks from it.
+    auto latest = _worldGenSystem.getSnapshot();
+    if (latest->generationId != _currentGenerationId) {
+        adoptSnapshot(std::move(latest));
+        applyFullReload();
+    }
 
-    std::swap(worldState.activeParams, worldState.generatingParams);
-    worldState.pendingParams = worldState.activeParams;
+    processCompletions();
+    updateActiveChunks(dt);
+}
 
-    std::vector<sf::Vector2i> chunksToUnload;
-    for (const auto &pair : _activeChunks) {
-        chunksToUnload.push_back(pair.first);
+void ChunkManagerSystem::resetChunkIndex() {
+    _chunkIndex.reset(_snapshot->params.worldDimensionsInChunks, Constants::TERRAIN_LOD_MAX_LEVEL);
+    _activeChunkCount = 0;
+    _loadingChunkCount = 0;
+    _requiredRect = ChunkRect{};
+    _prefetchRect = ChunkRect{};
+    _missingChunks.clear();
+
+    // Chunks kept across a smooth regeneration stay active; ones that no longer fit the
+    // world are dropped. The next update re-enters every visible chunk from scratch.
+    std::vector<entt::entity> outsideWorld;
+    auto view = _registry.view<ChunkPositionComponent>();
+    for (auto entity : view) {
+        const auto &position = view.get<ChunkPositionComponent>(entity);
+        const ChunkKey key{position.chunkGridPosition, position.lodLevel};
+        if (!_chunkIndex.contains(key)) {
+            outsideWorld.push_back(entity);
+            continue;
+        }
+        ChunkSlot &slot = _chunkIndex[key];
+        slot.entity = entity;
+        setResidency(slot, ChunkResidency::Active);
     }
+    for (auto entity : outsideWorld) {
+        _registry.destroy(entity);
+    }
+    _sweepPending = true;
+}
+
+void ChunkManagerSystem::setResidency(ChunkSlot &slot, ChunkResidency residency) {
+    auto counterFor = [this](ChunkResidency state) -> std::size_t * {
+        switch (state) {
+        case ChunkResidency::Active:
+            return &_activeChunkCount;
+        case ChunkResidency::Loading:
+            return &_loadingChunkCount;
+        default:
+            return nullptr;
+        }
+    };
 
-    for (const auto &chunkPos : chunksToUnload) {
-        unloadChunk(chunkPos);
+    if (std::size_t *previous = counterFor(slot.residency)) {
+        --*previous;
+    }
+    if (std::size_t *next = counterFor(residency)) {
+        ++*next;
+    }
+    slot.residency = residency;
+    if (residency != ChunkResidency::Active) {
+        slot.entity = entt::null;
+    }
+    if (residency != ChunkResidency::Loading) {
+        slot.cancelled = {};
     }
+}
 
-    _pendingChunkUpdates.clear();
-    ++_currentGenerationId;
-    _performingFullReload = false;
-    _smoothRegenPending = false;
+entt::entity ChunkManagerSystem::findActiveChunk(const ChunkKey &key) const {
+    if (!_chunkIndex.contains(key)) {
+        return entt::null;
+    }
+    const ChunkSlot &slot = _chunkIndex[key];
+    return slot.residency == ChunkResidency::Active ? slot.entity : entt::null;
 }
 
-void ChunkManagerSystem::update(sf::Time dt) {
-    handleWorldGeneration();
-    handleChunkLoading();
-    processChunkRegeneration();
-    if (_smoothRegenPending && _pendingChunkUpdates.empty() && !_performingFullReload) {
-        auto &worldState =
-            _registry.get<WorldStateComponent>(_registry.view<WorldStateComponent>().front());
-        LOG_DEBUG("ChunkManagerSystem", "Processing queued smooth regeneration request.");
-        WorldGenParams params = worldState.pendingParams;
-        worldState.activeParams = params;
-        _worldGenSystem.regenerate(params);
-        startSmoothRegeneration(params);
-        _smoothRegenPending = false;
-    }
-    updateActiveChunks();
-}
-
-void ChunkManagerSystem::loadChunk(const sf::Vector2i &chunkPos) {
-    const auto &worldParams = _worldGenSystem.getParams();
-    const auto &worldDims = worldParams.worldDimensionsInChunks;
-
-    if (chunkPos.x < 0 || chunkPos.x >= worldDims.x || chunkPos.y < 0
-        || chunkPos.y >= worldDims.y) {
+bool ChunkManagerSystem::isWanted(const ChunkKey &key) const {
+    return _requiredRect.contains(key) || _prefetchRect.contains(key);
+}
+
+void ChunkManagerSystem::destroyAllChunks() {
+    auto view = _registry.view<ChunkPositionComponent>();
+    _registry.destroy(view.begin(), view.end());
+}
+
+void ChunkManagerSystem::loadChunk(const ChunkKey &key, bool prefetch) {
+    const auto &worldParams = _snapshot->params;
+    auto cancelled = CancellationToken::create(_generationToken);
+    ChunkSlot &slot = _chunkIndex[key];
+    setResidency(slot, ChunkResidency::Loading);
+    slot.cancelled = cancelled;
+    slot.prefetch = prefetch;
+    _retentionCache.recordMiss();
+
+    // Once the world raster is built a chunk is only a copy out of it, cheaper than a read.
+    ChunkCompletion completion;
+    completion.key = key;
+    completion.cancelled = cancelled;
+    if (_worldRaster.findReady(_currentGenerationId)) {
+        completion.kind = ChunkCompletion::Kind::Load;
+        enqueueChunkGeneration(std::move(completion), nullptr, chunkPriority(key));
         return;
     }
 
-    _chunksBeingLoaded.insert(chunkPos);
+    // Check the disk cache on the I/O threads first; misses fall through to the noise
+    // workers in handleCacheLookup().
+    completion.kind = ChunkCompletion::Kind::Lookup;
+    const std::uint64_t fingerprint = _cacheFingerprint;
+    const std::size_t cellCount = static_cast<std::size_t>(worldParams.chunkDimensionsInCells.x)
+                                  * worldParams.chunkDimensionsInCells.y;
+    auto lookup = [this, ticket = _chunkTasks.track(), fingerprint, cellCount,
+                   completion = std::move(completion)]() mutable {
+        if (completion.cancelled.isCancelled()) {
+            return;
+        }
+        completion.chunkData = _diskCache->load(fingerprint, completion.key.position,
+                                               completion.key.lodLevel, cellCount);
+        _completions.push(std::move(completion));
+    };
+    _threadPool.post(TaskPriority::Io, std::move(lookup));
+}
 
-    auto task = [this, chunkPos]() { return _worldGenSystem.generateChunkData(chunkPos); };
-    _chunkLoadFutures.emplace_back(_threadPool.enqueue(task));
+TaskPriority ChunkManagerSystem::chunkPriority(const ChunkKey &key) const {
+    return _chunkIndex[key].prefetch ? TaskPriority::Streaming : TaskPriority::Interactive;
 }
 
-void ChunkManagerSystem::unloadChunk(const sf::Vector2i &chunkPos) {
-    auto it = _activeChunks.find(chunkPos);
-    if (it != _activeChunks.end()) {
-        _registry.destroy(it->second);
-        _activeChunks.erase(it);
-        LOG_TRACE("ChunkManagerSystem", "Unloaded chunk at (%d, %d)", chunkPos.x, chunkPos.y);
+void ChunkManagerSystem::cancelChunkRequest(const ChunkKey &key) {
+    ChunkSlot &slot = _chunkIndex[key];
+    // Tasks still queued in the pools see the token and return without sampling; running
+    // ones stop at their next noise field.
+    slot.cancelled.cancel();
+    if (slot.prefetch) {
+        ++_streamingStats.prefetchWasted;
+        slot.prefetch = false;
     }
+    setResidency(slot, ChunkResidency::Absent);
+    LOG_TRACE("ChunkManagerSystem", "Cancelled chunk request at (%d, %d) LOD %d",
+              key.position.x, key.position.y, key.lodLevel);
 }
 
-void ChunkManagerSystem::processCompletedChunks() {
-    std::lock_guard<std::mutex> lock(_completedChunksMutex);
-    while (!_completedChunks.empty()) {
-        GeneratedChunkData chunkData = std::move(_completedChunks.front());
-        _completedChunks.pop();
+void ChunkManagerSystem::enqueueChunkGeneration(
+    ChunkCompletion completion, std::shared_ptr<const ChunkNoiseFields> previousFields,
+    TaskPriority priority) {
+    // The task owns its snapshot, so the result always matches the captured fingerprint
+    // and can be written back even if the world has been regenerated since.
+    // Updates belong to a smooth regeneration, which runs for every tweak while the world is
+    // being tuned. Those chunks are written back once loaded normally for params that stick.
+    const bool writeBack =
+        _diskCache->isEnabled() && completion.kind != ChunkCompletion::Kind::Update;
+    auto diskCache = writeBack ? _diskCache : nullptr;
+    const std::uint64_t fingerprint = _cacheFingerprint;
+
+    auto generate = [this, ticket = _chunkTasks.track(), diskCache = std::move(diskCache),
+                     fingerprint, snapshot = _snapshot,
+                     previousFields = std::move(previousFields),
+                     completion = std::move(completion)]() mutable {
+        const ChunkKey &key = completion.key;
+        const CancellationToken &cancelled = completion.cancelled;
+        if (cancelled.isCancelled()) {
+            return;
+        }
 
-        sf::Vector2i chunkPos = chunkData.chunkGridPosition;
+        // Chunks of a snapshot whose raster is built are cut from it instead of sampling the
+        // noise a second time. A raster still building is not waited for: it covers the
+        // whole world, and a visible chunk generates far sooner on its own.
+        if (auto raster = _worldRaster.findReady(snapshot->generationId)) {
+            GeneratedChunkData chunkData;
+            chunkData.chunkGridPosition = key.position;
+            chunkData.lodLevel = key.lodLevel;
+            raster->copyChunk(snapshot->params.chunkDimensionsInCells, chunkData);
+            completion.chunkData = std::move(chunkData);
+            _completions.push(std::move(completion));
+            return;
+        }
 
-        auto entity = _registry.create();
-        _registry.emplace<ChunkPositionComponent>(entity, chunkPos);
-        _registry.emplace<ChunkTerrainComponent>(entity, std::move(chunkData.cells));
-        _registry.emplace<ChunkElevationComponent>(entity, std::move(chunkData.elevations));
-        _registry.emplace<ChunkStateComponent>(entity);
-        _registry.emplace<ChunkMeshComponent>(entity);
+        GeneratedChunkData chunkData = WorldGenerationSystem::generateChunkData(
+            *snapshot, key.position, key.lodLevel, previousFields, cancelled);
+        // A chunk abandoned part way has no cells and must not reach the cache.
+        if (cancelled.isCancelled()) {
+            return;
+        }
+        if (diskCache) {
+            _threadPool.post(TaskPriority::Io, [diskCache, fingerprint, chunkData]() {
+                diskCache->store(fingerprint, chunkData);
+            });
+        }
+        completion.chunkData = std::move(chunkData);
+        _completions.push(std::move(completion));
+    };
+    _threadPool.post(priority, std::move(generate));
+}
 
-        _activeChunks[chunkPos] = entity;
-        _chunksBeingLoaded.erase(chunkPos);
-        LOG_TRACE("ChunkManagerSystem", "Finalized loaded chunk at (%d, %d)", chunkPos.x,
-                 chunkPos.y);
+entt::entity
+ChunkManagerSystem::createChunkEntity(const ChunkKey &key, PackedTerrainCells cells,
+                                      QuantizedElevations elevations,
+                                      std::shared_ptr<const ChunkNoiseFields> noiseFields) {
+    auto entity = _registry.create();
+    _registry.emplace<ChunkPositionComponent>(entity, key.position, key.lodLevel);
+    _registry.emplace<ChunkTerrainComponent>(entity, std::move(cells));
+    _registry.emplace<ChunkElevationComponent>(entity, std::move(elevations));
+    _registry.emplace<ChunkNoiseFieldsComponent>(entity, std::move(noiseFields));
+    _registry.emplace<ChunkStateComponent>(entity);
+    _registry.emplace<ChunkMeshComponent>(entity);
+
+    ChunkSlot &slot = _chunkIndex[key];
+    setResidency(slot, ChunkResidency::Active);
+    slot.entity = entity;
+    return entity;
+}
+
+bool ChunkManagerSystem::restoreRetainedChunk(const ChunkKey &key) {
+    if (_chunkIndex[key].residency != ChunkResidency::Retained) {
+        return false;
     }
+    std::optional<RetainedChunk> retained = _retentionCache.take(key);
+    if (!retained) {
+        setResidency(_chunkIndex[key], ChunkResidency::Absent);
+        return false;
+    }
+
+    auto entity = createChunkEntity(key, std::move(retained->cells),
+                                    std::move(retained->elevations),
+                                    std::move(retained->noiseFields));
+    _registry.get<ChunkMeshComponent>(entity).vertexArray = std::move(retained->mesh);
+    _registry.get<ChunkStateComponent>(entity).isMeshDirty = retained->isMeshDirty;
+    LOG_TRACE("ChunkManagerSystem", "Restored retained chunk at (%d, %d) LOD %d",
+              key.position.x, key.position.y, key.lodLevel);
+    return true;
 }
 
-void ChunkManagerSystem::processChunkRegeneration() {
-    if (_pendingChunkUpdates.empty()) {
+void ChunkManagerSystem::unloadChunk(const ChunkKey &key, bool retain) {
+    ChunkSlot &slot = _chunkIndex[key];
+    if (slot.residency != ChunkResidency::Active) {
         return;
     }
 
-    const std::size_t currentGenerationId = _currentGenerationId;
-
-    _pendingChunkUpdates.erase(
-        std::remove_if(_pendingChunkUpdates.begin(), _pendingChunkUpdates.end(),
-                       [this, currentGenerationId](PendingChunkUpdate &pending) {
-                           if (pending.future.wait_for(std::chrono::seconds(0))
-                               != std::future_status::ready) {
-                               return false;
-                           }
+    const entt::entity entity = slot.entity;
+    if (slot.prefetch) {
+        ++_streamingStats.prefetchWasted;
+        slot.prefetch = false;
+    }
 
-                           GeneratedChunkData chunkData = pending.future.get();
-                           if (pending.generationId != currentGenerationId) {
-                               return true;
-                           }
+    if (retain && _registry.valid(entity)) {
+        RetainedChunk chunk;
+        chunk.cells = std::move(_registry.get<ChunkTerrainComponent>(entity).cells);
+        chunk.elevations = std::move(_registry.get<ChunkElevationComponent>(entity).elevations);
+        if (auto *noise = _registry.try_get<ChunkNoiseFieldsComponent>(entity)) {
+            chunk.noiseFields = std::move(noise->fields);
+        }
+        chunk.mesh = std::move(_registry.get<ChunkMeshComponent>(entity).vertexArray);
+        chunk.isMeshDirty = _registry.get<ChunkStateComponent>(entity).isMeshDirty;
+        setResidency(slot, ChunkResidency::Retained);
+
+        for (const auto &evictedKey : _retentionCache.insert(key, std::move(chunk))) {
+            ChunkSlot &evicted = _chunkIndex[evictedKey];
+            if (evicted.residency == ChunkResidency::Retained) {
+                setResidency(evicted, ChunkResidency::Absent);
+            }
+        }
+    } else {
+        setResidency(slot, ChunkResidency::Absent);
+    }
 
-                           if (!_registry.valid(pending.entity)
-                               || !_registry.all_of<ChunkTerrainComponent, ChunkStateComponent>(
-                                   pending.entity)) {
-                               return true;
-                           }
+    if (_registry.valid(entity)) {
+        _registry.destroy(entity);
+    }
+    LOG_TRACE("ChunkManagerSystem", "Unloaded chunk at (%d, %d) LOD %d", key.position.x,
+              key.position.y, key.lodLevel);
+}
 
-                           auto &chunkTerrain =
-                               _registry.get<ChunkTerrainComponent>(pending.entity);
-                           chunkTerrain.cells = std::move(chunkData.cells);
+void ChunkManagerSystem::processCompletions() {
+    _completions.drain([this](ChunkCompletion &&completion) {
+        switch (completion.kind) {
+        case ChunkCompletion::Kind::Lookup:
+            handleCacheLookup(completion);
+            break;
+        case ChunkCompletion::Kind::Load:
+            finishChunkLoad(completion);
+            break;
+        case ChunkCompletion::Kind::Update:
+            applyChunkUpdate(completion);
+            break;
+        }
+    });
+}
 
-                           if (_registry.all_of<ChunkElevationComponent>(pending.entity)) {
-                               auto &elevation =
-                                   _registry.get<ChunkElevationComponent>(pending.entity);
-                               elevation.elevations = std::move(chunkData.elevations);
-                           }
+void ChunkManagerSystem::handleCacheLookup(ChunkCompletion &completion) {
+    if (completion.chunkData) {
+        finishChunkLoad(completion);
+    } else if (!completion.cancelled.isCancelled()) {
+        const TaskPriority priority = chunkPriority(completion.key);
+        completion.kind = ChunkCompletion::Kind::Load;
+        enqueueChunkGeneration(std::move(completion), nullptr, priority);
+    }
+}
 
-                           auto &chunkState = _registry.get<ChunkStateComponent>(pending.entity);
-                           chunkState.isMeshDirty = true;
-                           return true;
-                       }),
-        _pendingChunkUpdates.end());
+void ChunkManagerSystem::finishChunkLoad(ChunkCompletion &completion) {
+    if (!finishChunkRequest(completion.key, completion.cancelled)) {
+        return;
+    }
+    const ChunkKey &key = completion.key;
+    GeneratedChunkData &chunkData = *completion.chunkData;
+    createChunkEntity(key, std::move(chunkData.cells), std::move(chunkData.elevations),
+                      std::move(chunkData.noiseFields));
+    LOG_TRACE("ChunkManagerSystem", "Finalized loaded chunk at (%d, %d) LOD %d",
+              key.position.x, key.position.y, key.lodLevel);
 }
 
-void ChunkManagerSystem::handleWorldGeneration() {
-    if (_generationFuture.valid()
-        && _generationFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-        _generationFuture.get();
-        _eventBus.trigger(SwapWorldStateEvent{});
+void ChunkManagerSystem::applyChunkUpdate(ChunkCompletion &completion) {
+    const entt::entity entity = completion.entity;
+    if (completion.generationId != _currentGenerationId || !_registry.valid(entity)
+        || !_registry.all_of<ChunkTerrainComponent, ChunkStateComponent>(entity)) {
+        return;
+    }
+
+    GeneratedChunkData &chunkData = *completion.chunkData;
+    auto &chunkTerrain = _registry.get<ChunkTerrainComponent>(entity);
+    chunkTerrain.cells = std::move(chunkData.cells);
+
+    if (_registry.all_of<ChunkElevationComponent>(entity)) {
+        auto &elevation = _registry.get<ChunkElevationComponent>(entity);
+        elevation.elevations = std::move(chunkData.elevations);
     }
+
+    _registry.emplace_or_replace<ChunkNoiseFieldsComponent>(entity,
+                                                            std::move(chunkData.noiseFields));
+
+    auto &chunkState = _registry.get<ChunkStateComponent>(entity);
+    chunkState.isMeshDirty = true;
 }
 
-void ChunkManagerSystem::handleChunkLoading() {
-    _chunkLoadFutures.erase(
-        std::remove_if(_chunkLoadFutures.begin(), _chunkLoadFutures.end(),
-                       [this](std::future<GeneratedChunkData> &f) {
-                           if (f.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-                               std::lock_guard<std::mutex> lock(_completedChunksMutex);
-                               _completedChunks.push(f.get());
-                               return true;
-                           }
-                           return false;
-                       }),
-        _chunkLoadFutures.end());
+bool ChunkManagerSystem::finishChunkRequest(const ChunkKey &key,
+                                            const CancellationToken &cancelled) {
+    // Cancelled, and possibly requested again since, when the slot holds another token.
+    return _chunkIndex.contains(key) && _chunkIndex[key].residency == ChunkResidency::Loading
+           && _chunkIndex[key].cancelled == cancelled;
+}
 
-    processCompletedChunks();
+ChunkStreamingStats ChunkManagerSystem::getStreamingStats() const {
+    ChunkStreamingStats stats = _streamingStats;
+    stats.activeChunks = _activeChunkCount;
+    stats.requestsInFlight = _loadingChunkCount;
+    stats.retention = _retentionCache.getStats();
+    return stats;
 }
 
-void ChunkManagerSystem::updateActiveChunks() {
-    const auto& worldParams = _worldGenSystem.getParams();
-    float chunkWidthInPixels = worldParams.chunkDimensionsInCells.x * worldParams.cellSize;
-    float chunkHeightInPixels = worldParams.chunkDimensionsInCells.y * worldParams.cellSize;
+void ChunkManagerSystem::updateActiveChunks(sf::Time dt) {
+    const auto& worldParams = _snapshot->params;
+    const float chunkWidthInPixels = worldParams.chunkDimensionsInCells.x * worldParams.cellSize;
+    const float chunkHeightInPixels = worldParams.chunkDimensionsInCells.y * worldParams.cellSize;
 
     sf::Vector2f cameraCenter = _camera.getCenter();
     sf::Vector2f viewSize = _camera.getView().getSize();
+    updateCameraMotion(dt, cameraCenter, viewSize);
+
+    // Pick the pyramid level from the view so the number of chunks on screen, and with it
+    // memory and mesh vertices, stays roughly constant at any zoom.
+    _currentLodLevel = selectLodLevel(viewSize, chunkWidthInPixels, chunkHeightInPixels);
+
+    const ChunkRect requiredRect = viewRect(cameraCenter, viewSize, _currentLodLevel);
+
+    // Extrapolate the view along the current pan and zoom. The offset is capped at one
+    // view so a single fast frame cannot send prefetches far off screen.
+    const float lookahead = Constants::CHUNK_PREFETCH_LOOKAHEAD_S;
+    const sf::Vector2f offset = {
+        std::clamp(_cameraVelocity.x * lookahead, -viewSize.x, viewSize.x),
+        std::clamp(_cameraVelocity.y * lookahead, -viewSize.y, viewSize.y)};
+    const float zoomFactor = std::clamp(std::exp(_cameraZoomRate * lookahead), 0.5f, 2.0f);
+    const sf::Vector2f predictedViewSize = viewSize * zoomFactor;
+    const int predictedLodLevel =
+        selectLodLevel(predictedViewSize, chunkWidthInPixels, chunkHeightInPixels);
+
+    ChunkRect prefetchRect =
+        viewRect(cameraCenter + offset, predictedViewSize, predictedLodLevel);
+    if (prefetchRect == requiredRect) {
+        prefetchRect = ChunkRect{};
+    }
 
-    int viewDistanceX = static_cast<int>(std::ceil(viewSize.x / 2.0f / chunkWidthInPixels)) + 1;
-    int viewDistanceY = static_cast<int>(std::ceil(viewSize.y / 2.0f / chunkHeightInPixels)) + 1;
+    if (requiredRect != _requiredRect || prefetchRect != _prefetchRect) {
+        updateVisibility(requiredRect, prefetchRect);
+    }
+
+    scheduleChunkRequests(cameraCenter);
+
+    if (_sweepPending) {
+        sweepUnwantedChunks();
+    }
+}
 
-    sf::Vector2i centerChunk = {static_cast<int>(cameraCenter.x / chunkWidthInPixels),
-                                static_cast<int>(cameraCenter.y / chunkHeightInPixels)};
+void ChunkManagerSystem::updateVisibility(const ChunkRect &requiredRect,
+                                          const ChunkRect &prefetchRect) {
+    const ChunkRect oldRequired = _requiredRect;
+    const ChunkRect oldPrefetch = _prefetchRect;
+    _requiredRect = requiredRect;
+    _prefetchRect = prefetchRect;
+
+    // Only the strips that moved in or out of view are visited.
+    oldRequired.forEachOutside(requiredRect, [&](const ChunkKey &key) {
+        if (!prefetchRect.contains(key)) {
+            leaveView(key);
+        }
+    });
+    oldPrefetch.forEachOutside(prefetchRect, [&](const ChunkKey &key) {
+        if (!oldRequired.contains(key) && !requiredRect.contains(key)) {
+            leaveView(key);
+        }
+    });
 
-    std::set<sf::Vector2i, Vector2iCompare> requiredChunks;
-    for (int y = centerChunk.y - viewDistanceY; y <= centerChunk.y + viewDistanceY; ++y) {
-        for (int x = centerChunk.x - viewDistanceX; x <= centerChunk.x + viewDistanceX; ++x) {
-            requiredChunks.insert({x, y});
+    requiredRect.forEachOutside(oldRequired, [&](const ChunkKey &key) {
+        ChunkSlot &slot = _chunkIndex[key];
+        if (slot.prefetch) {
+            slot.prefetch = false;
+            ++_streamingStats.prefetchHits;
+        }
+        if (!oldPrefetch.contains(key)) {
+            enterView(key);
         }
+    });
+    prefetchRect.forEachOutside(oldPrefetch, [&](const ChunkKey &key) {
+        if (!requiredRect.contains(key) && !oldRequired.contains(key)) {
+            enterView(key);
+        }
+    });
+}
+
+void ChunkManagerSystem::enterView(const ChunkKey &key) {
+    // Retained chunks come back immediately and never take an in-flight slot.
+    const ChunkResidency residency = _chunkIndex[key].residency;
+    if (residency == ChunkResidency::Retained && restoreRetainedChunk(key)) {
+        return;
+    }
+    if (_chunkIndex[key].residency == ChunkResidency::Absent) {
+        _missingChunks.push_back(key);
+    }
+}
+
+void ChunkManagerSystem::leaveView(const ChunkKey &key) {
+    switch (_chunkIndex[key].residency) {
+    case ChunkResidency::Loading:
+        cancelChunkRequest(key);
+        break;
+    case ChunkResidency::Active:
+        // Chunks from the previous level keep covering the screen until every chunk of
+        // the new level has arrived, so a level switch never shows holes.
+        if (key.lodLevel == _currentLodLevel) {
+            unloadChunk(key, true);
+        } else {
+            _sweepPending = true;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void ChunkManagerSystem::sweepUnwantedChunks() {
+    bool currentLevelComplete = true;
+    _requiredRect.forEach([&](const ChunkKey &key) {
+        currentLevelComplete &= _chunkIndex[key].residency == ChunkResidency::Active;
+    });
+    if (!currentLevelComplete) {
+        return;
     }
 
-    std::vector<sf::Vector2i> chunksToUnload;
-    for (const auto &pair : _activeChunks) {
-        if (requiredChunks.find(pair.first) == requiredChunks.end()) {
-            chunksToUnload.push_back(pair.first);
+    std::vector<ChunkKey> chunksToUnload;
+    auto view = _registry.view<ChunkPositionComponent>();
+    for (auto entity : view) {
+        const auto &position = view.get<ChunkPositionComponent>(entity);
+        const ChunkKey key{position.chunkGridPosition, position.lodLevel};
+        if (!isWanted(key)) {
+            chunksToUnload.push_back(key);
         }
     }
 
-    for (const auto &chunkPos : chunksToUnload) {
-        unloadChunk(chunkPos);
+    for (const auto &key : chunksToUnload) {
+        unloadChunk(key, true);
+    }
+    _sweepPending = false;
+}
+
+void ChunkManagerSystem::updateCameraMotion(sf::Time dt, const sf::Vector2f &cameraCenter,
+                                            const sf::Vector2f &viewSize) {
+    const float seconds = dt.asSeconds();
+    if (_hasCameraSample && seconds > 0.0f) {
+        const sf::Vector2f velocity = (cameraCenter - _lastCameraCenter) / seconds;
+        // Zoom is tracked as the log of the view scale so zooming in and out are symmetric.
+        const float zoomRate = std::log(viewSize.x / _lastViewSize.x) / seconds;
+
+        const float blend = std::min(1.0f, seconds / Constants::CHUNK_PREFETCH_SMOOTHING_S);
+        _cameraVelocity += (velocity - _cameraVelocity) * blend;
+        _cameraZoomRate += (zoomRate - _cameraZoomRate) * blend;
+    }
+
+    _lastCameraCenter = cameraCenter;
+    _lastViewSize = viewSize;
+    _hasCameraSample = true;
+}
+
+ChunkRect ChunkManagerSystem::viewRect(const sf::Vector2f &center, const sf::Vector2f &viewSize,
+                                       int lodLevel) const {
+    const auto &worldParams = _snapshot->params;
+    const float step = static_cast<float>(1 << lodLevel);
+    const float chunkWidth = worldParams.chunkDimensionsInCells.x * worldParams.cellSize * step;
+    const float chunkHeight = worldParams.chunkDimensionsInCells.y * worldParams.cellSize * step;
+
+    int viewDistanceX = static_cast<int>(std::ceil(viewSize.x / 2.0f / chunkWidth)) + 1;
+    int viewDistanceY = static_cast<int>(std::ceil(viewSize.y / 2.0f / chunkHeight)) + 1;
+
+    sf::Vector2i centerChunk = {static_cast<int>(center.x / chunkWidth),
+                                static_cast<int>(center.y / chunkHeight)};
+
+    ChunkRect rect;
+    rect.lodLevel = lodLevel;
+    rect.min = {centerChunk.x - viewDistanceX, centerChunk.y - viewDistanceY};
+    rect.max = {centerChunk.x + viewDistanceX, centerChunk.y + viewDistanceY};
+    return _chunkIndex.clip(rect);
+}
+
+float ChunkManagerSystem::chunkDistanceSquared(const ChunkKey &key,
+                                               const sf::Vector2f &point) const {
+    const auto &worldParams = _snapshot->params;
+    const float step = static_cast<float>(1 << key.lodLevel);
+    const float chunkWidth = worldParams.chunkDimensionsInCells.x * worldParams.cellSize * step;
+    const float chunkHeight = worldParams.chunkDimensionsInCells.y * worldParams.cellSize * step;
+    const float dx = (static_cast<float>(key.position.x) + 0.5f) * chunkWidth - point.x;
+    const float dy = (static_cast<float>(key.position.y) + 0.5f) * chunkHeight - point.y;
+    return dx * dx + dy * dy;
+}
+
+void ChunkManagerSystem::scheduleChunkRequests(const sf::Vector2f &cameraCenter) {
+    // Drop entries that were loaded, restored or scrolled away since they were queued.
+    _missingChunks.erase(std::remove_if(_missingChunks.begin(), _missingChunks.end(),
+                                        [this](const ChunkKey &key) {
+                                            return !isWanted(key)
+                                                   || _chunkIndex[key].residency
+                                                          != ChunkResidency::Absent;
+                                        }),
+                         _missingChunks.end());
+
+    std::vector<ChunkKey> missingRequired;
+    std::vector<ChunkKey> missingPrefetch;
+    for (const auto &key : _missingChunks) {
+        (_requiredRect.contains(key) ? missingRequired : missingPrefetch).push_back(key);
     }
 
-    for (const auto &chunkPos : requiredChunks) {
-        if (_activeChunks.find(chunkPos) == _activeChunks.end()
-            && _chunksBeingLoaded.find(chunkPos) == _chunksBeingLoaded.end()) {
-            loadChunk(chunkPos);
+    // Re-ranked every frame, so after a pan the chunks now on screen go first and
+    // prefetches nearest the leading edge only use the slots that are left over.
+    auto dispatchNearest = [&](std::vector<ChunkKey> &missing, std::size_t limit,
+                               bool prefetch) {
+        const std::size_t dispatchCount = std::min(limit, missing.size());
+        std::partial_sort(missing.begin(), missing.begin() + dispatchCount, missing.end(),
+                          [&](const ChunkKey &lhs, const ChunkKey &rhs) {
+                              return chunkDistanceSquared(lhs, cameraCenter)
+                                     < chunkDistanceSquared(rhs, cameraCenter);
+                          });
+        for (std::size_t i = 0; i < dispatchCount; ++i) {
+            loadChunk(missing[i], prefetch);
         }
+        return dispatchCount;
+    };
+
+    auto freeSlots = [this]() {
+        return Constants::CHUNK_MAX_IN_FLIGHT_REQUESTS
+               - std::min(_loadingChunkCount, Constants::CHUNK_MAX_IN_FLIGHT_REQUESTS);
+    };
+
+    dispatchNearest(missingRequired, freeSlots(), false);
+
+    if (missingPrefetch.empty()) {
+        return;
     }
+    std::size_t prefetchesInFlight = 0;
+    _prefetchRect.forEach([&](const ChunkKey &key) {
+        const ChunkSlot &slot = _chunkIndex[key];
+        prefetchesInFlight += slot.residency == ChunkResidency::Loading && slot.prefetch;
+    });
+    if (prefetchesInFlight >= Constants::CHUNK_PREFETCH_MAX_IN_FLIGHT) {
+        return;
+    }
+    const std::size_t prefetchBudget =
+        std::min(freeSlots(), Constants::CHUNK_PREFETCH_MAX_IN_FLIGHT - prefetchesInFlight);
+    _streamingStats.prefetchRequested += dispatchNearest(missingPrefetch, prefetchBudget, true);
+}
+
+int ChunkManagerSystem::selectLodLevel(const sf::Vector2f &viewSize, float chunkWidth,
+                                       float chunkHeight) const {
+    const float chunksAcross = std::max(viewSize.x / chunkWidth, viewSize.y / chunkHeight);
+    auto acrossAtLevel = [chunksAcross](int level) {
+        return chunksAcross / static_cast<float>(1 << level);
+    };
+
+    int level = _currentLodLevel;
+    while (level < Constants::TERRAIN_LOD_MAX_LEVEL
+           && acrossAtLevel(level) > Constants::TERRAIN_LOD_MAX_CHUNKS_ACROSS) {
+        ++level;
+    }
+    while (level > 0
+           && acrossAtLevel(level - 1)
+                  < Constants::TERRAIN_LOD_MAX_CHUNKS_ACROSS * Constants::TERRAIN_LOD_HYSTERESIS) {
+        --level;
+    }
+    return level;
 }
 
 bool ChunkManagerSystem::requiresFullReload(const WorldGenParams &currentParams,
@@ -286,25 +732,31 @@ bool ChunkManagerSystem::requiresFullReload(const WorldGenParams &currentParams,
 }
 
 void ChunkManagerSystem::startSmoothRegeneration(const WorldGenParams &params) {
-    if (_activeChunks.empty()) {
+    if (_activeChunkCount == 0) {
         return;
     }
 
-    ++_currentGenerationId;
     const std::size_t generationId = _currentGenerationId;
 
     struct ChunkRegenTarget {
-        sf::Vector2i position;
+        ChunkKey key;
         entt::entity entity;
+        std::shared_ptr<const ChunkNoiseFields> noiseFields;
     };
 
     std::vector<ChunkRegenTarget> targets;
-    targets.reserve(_activeChunks.size());
-
-    for (const auto &pair : _activeChunks) {
-        if (_registry.valid(pair.second)) {
-            targets.push_back({pair.first, pair.second});
+    targets.reserve(_activeChunkCount);
+
+    auto view = _registry.view<ChunkPositionComponent>();
+    for (auto entity : view) {
+        const auto &position = view.get<ChunkPositionComponent>(entity);
+        // Layers whose noise settings did not change are recombined, not resampled.
+        std::shared_ptr<const ChunkNoiseFields> noiseFields;
+        if (const auto *cached = _registry.try_get<ChunkNoiseFieldsComponent>(entity)) {
+            noiseFields = cached->fields;
         }
+        targets.push_back(
+            {{position.chunkGridPosition, position.lodLevel}, entity, std::move(noiseFields)});
     }
 
     if (targets.empty()) {
@@ -315,11 +767,12 @@ void ChunkManagerSystem::startSmoothRegeneration(const WorldGenParams &params) {
     const float chunkHeight = params.chunkDimensionsInCells.y * params.cellSize;
     const sf::Vector2f cameraCenter = _camera.getCenter();
 
-    auto distanceSquared = [&](const sf::Vector2i &chunkPos) {
+    auto distanceSquared = [&](const ChunkKey &key) {
+        const float step = static_cast<float>(1 << key.lodLevel);
         const float chunkCenterX =
-            (static_cast<float>(chunkPos.x) + 0.5f) * chunkWidth;
+            (static_cast<float>(key.position.x) + 0.5f) * chunkWidth * step;
         const float chunkCenterY =
-            (static_cast<float>(chunkPos.y) + 0.5f) * chunkHeight;
+            (static_cast<float>(key.position.y) + 0.5f) * chunkHeight * step;
         const float dx = chunkCenterX - cameraCenter.x;
         const float dy = chunkCenterY - cameraCenter.y;
         return dx * dx + dy * dy;
@@ -327,52 +780,32 @@ void ChunkManagerSystem::startSmoothRegeneration(const WorldGenParams &params) {
 
     std::sort(targets.begin(), targets.end(),
               [&](const ChunkRegenTarget &lhs, const ChunkRegenTarget &rhs) {
-            return distanceSquared(lhs.position) < distanceSquared(rhs.position);
+            return distanceSquared(lhs.key) < distanceSquared(rhs.key);
               });
 
     for (auto &target : targets) {
-        auto future = _threadPool.enqueue([this, chunkPos = target.position]() {
-            return _worldGenSystem.generateChunkData(chunkPos);
-        });
-
-        _pendingChunkUpdates.push_back(
-            PendingChunkUpdate{target.position, target.entity, std::move(future), generationId});
+        // Every chunk being regenerated is already on screen.
+        ChunkCompletion completion;
+        completion.kind = ChunkCompletion::Kind::Update;
+        completion.key = target.key;
+        completion.cancelled = _generationToken;
+        completion.entity = target.entity;
+        completion.generationId = generationId;
+        enqueueChunkGeneration(std::move(completion), std::move(target.noiseFields),
+                               TaskPriority::Interactive);
     }
 }
 
 void ChunkManagerSystem::loadChunksFromData(const std::vector<GeneratedChunkData> &chunks) {
-    if (_generationFuture.valid()) {
-        _generationFuture.wait();
-    }
-
-    _chunkLoadFutures.clear();
-    _pendingChunkUpdates.clear();
-    _chunksBeingLoaded.clear();
-    {
-        std::lock_guard<std::mutex> lock(_completedChunksMutex);
-        std::queue<GeneratedChunkData> empty;
-        std::swap(_completedChunks, empty);
-    }
+    // Requests still in flight are cancelled with the snapshot they were made for.
+    _completions.clear();
+    destroyAllChunks();
+    adoptSnapshot(_worldGenSystem.getSnapshot());
 
-    for (const auto &pair : _activeChunks) {
-        if (_registry.valid(pair.second)) {
-            _registry.destroy(pair.second);
+    for (const auto &chunkData : chunks) {
+        const ChunkKey key{chunkData.chunkGridPosition, chunkData.lodLevel};
+        if (_chunkIndex.contains(key)) {
+            createChunkEntity(key, chunkData.cells, chunkData.elevations, nullptr);
         }
     }
-    _activeChunks.clear();
-
-    for (const auto &chunkData : chunks) {
-        auto entity = _registry.create();
-        _registry.emplace<ChunkPositionComponent>(entity, chunkData.chunkGridPosition);
-        _registry.emplace<ChunkTerrainComponent>(entity, chunkData.cells);
-        _registry.emplace<ChunkElevationComponent>(entity, chunkData.elevations);
-        auto &state = _registry.emplace<ChunkStateComponent>(entity);
-        state.isMeshDirty = true;
-        _registry.emplace<ChunkMeshComponent>(entity);
-        _activeChunks[chunkData.chunkGridPosition] = entity;
-    }
-
-    _currentGenerationId = 0;
-    _performingFullReload = false;
-    _smoothRegenPending = false;
 }
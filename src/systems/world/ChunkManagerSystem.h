@@ -1,83 +1,190 @@
 #pragma once
 
 #include "WorldGenerationSystem.h"
+#include "core/CancellationToken.h"
+#include "core/CompletionQueue.h"
+#include "core/TaskTracker.h"
+#include "core/ThreadPool.h"
 #include "ecs/ISystem.h"
 #include "event/EventBus.h"
 #include "event/InputEvents.h"
+#include "event/UIEvents.h"
+#include "world/ChunkDiskCache.h"
+#include "world/ChunkGrid.h"
+#include "world/ChunkKey.h"
+#include "world/ChunkRetentionCache.h"
 #include "world/WorldData.h"
 #include <SFML/System/Vector2.hpp>
-#include <condition_variable>
-#include <future>
-#include <map>
-#include <mutex>
-#include <queue>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 class Camera;
-class ThreadPool;
+class WorldRaster;
 
-struct Vector2iCompare {
-    bool operator()(const sf::Vector2i &a, const sf::Vector2i &b) const {
-        if (a.x != b.x) return a.x < b.x;
-        return a.y < b.y;
-    }
+// Streaming counters shown in the debug overlay. A prefetch is a hit once its chunk comes
+// into view and wasted if it is cancelled or unloaded without ever having been visible.
+struct ChunkStreamingStats {
+    std::size_t activeChunks = 0;
+    std::size_t requestsInFlight = 0;
+    std::size_t prefetchRequested = 0;
+    std::size_t prefetchHits = 0;
+    std::size_t prefetchWasted = 0;
+    ChunkRetentionStats retention;
 };
 
 class ChunkManagerSystem : public ISystem, public IUpdatable {
 public:
-    explicit ChunkManagerSystem(entt::registry& registry, EventBus& eventBus, WorldGenerationSystem& worldGenSystem, Camera& camera, ThreadPool& threadPool);
+    explicit ChunkManagerSystem(entt::registry& registry, EventBus& eventBus, WorldGenerationSystem& worldGenSystem, WorldRaster& worldRaster, Camera& camera, ThreadPool& threadPool);
     ~ChunkManagerSystem();
     void update(sf::Time dt) override;
     void loadChunksFromData(const std::vector<GeneratedChunkData> &chunks);
+    ChunkStreamingStats getStreamingStats() const;
+
+    // The loaded chunk at `key`, or entt::null if it is absent or still loading.
+    entt::entity findActiveChunk(const ChunkKey &key) const;
 
 private:
     // Event Handlers
     void onRegenerateWorld(const RegenerateWorldRequestEvent &event);
-    void onSwapWorldState(const SwapWorldStateEvent &event);
+    void applyRegeneration(const WorldGenParams &params);
     void onImmediateRedraw(const ImmediateRedrawEvent &event);
+    void onThemeChanged(const ThemeChangedEvent &event);
+
+    enum class ChunkResidency : std::uint8_t { Absent, Loading, Active, Retained };
+
+    // Everything tracked about one chunk, stored densely per LOD level in _chunkIndex.
+    struct ChunkSlot {
+        ChunkResidency residency = ChunkResidency::Absent;
+        // Requested or loaded ahead of the camera and not yet on screen.
+        bool prefetch = false;
+        entt::entity entity = entt::null;
+        // While loading, a result is only accepted if it carries this same token, so a
+        // chunk that was cancelled and requested again ignores the earlier result. Cancelled
+        // when the chunk leaves the view before it has loaded, or with its generation.
+        CancellationToken cancelled;
+    };
+
+    // A finished chunk task, handed back to the main thread.
+    struct ChunkCompletion {
+        enum class Kind : std::uint8_t {
+            // A disk cache read; `chunkData` is empty on a miss.
+            Lookup,
+            // Generation of a chunk that is loading.
+            Load,
+            // Regeneration of an active chunk for a new snapshot.
+            Update,
+        };
+
+        Kind kind = Kind::Load;
+        ChunkKey key;
+        CancellationToken cancelled;
+        // Updates only: the chunk entity, and the snapshot it was regenerated for.
+        entt::entity entity = entt::null;
+        std::size_t generationId = 0;
+        std::optional<GeneratedChunkData> chunkData;
+    };
+
+    // Chunk Index
+    void resetChunkIndex();
+    void setResidency(ChunkSlot &slot, ChunkResidency residency);
+    bool isWanted(const ChunkKey &key) const;
+    void updateVisibility(const ChunkRect &requiredRect, const ChunkRect &prefetchRect);
+    void enterView(const ChunkKey &key);
+    void leaveView(const ChunkKey &key);
+    void sweepUnwantedChunks();
+    void destroyAllChunks();
 
     // Chunk Management
-    void loadChunk(const sf::Vector2i &chunkPos);
-    void unloadChunk(const sf::Vector2i &chunkPos);
-    void processCompletedChunks();
-    void processChunkRegeneration();
+    void loadChunk(const ChunkKey &key, bool prefetch = false);
+    void cancelChunkRequest(const ChunkKey &key);
+    // Generates `completion.key` and hands `completion` back with the result, unless its
+    // token is cancelled first.
+    void enqueueChunkGeneration(ChunkCompletion completion,
+                                std::shared_ptr<const ChunkNoiseFields> previousFields,
+                                TaskPriority priority);
+    // Visible chunks are Interactive; prefetched ones only Streaming.
+    TaskPriority chunkPriority(const ChunkKey &key) const;
+    entt::entity createChunkEntity(const ChunkKey &key, PackedTerrainCells cells,
+                                   QuantizedElevations elevations,
+                                   std::shared_ptr<const ChunkNoiseFields> noiseFields);
+    bool restoreRetainedChunk(const ChunkKey &key);
+    void unloadChunk(const ChunkKey &key, bool retain = false);
+    void processCompletions();
+    void handleCacheLookup(ChunkCompletion &completion);
+    void finishChunkLoad(ChunkCompletion &completion);
+    void applyChunkUpdate(ChunkCompletion &completion);
+
+    // Snapshot Handling
+    void adoptSnapshot(std::shared_ptr<const WorldGenSnapshot> snapshot);
+    void applyFullReload();
 
     // Update Helpers
-    void handleWorldGeneration();
-    void handleChunkLoading();
-    void updateActiveChunks();
+    void updateActiveChunks(sf::Time dt);
+    void updateCameraMotion(sf::Time dt, const sf::Vector2f &cameraCenter,
+                            const sf::Vector2f &viewSize);
+    ChunkRect viewRect(const sf::Vector2f &center, const sf::Vector2f &viewSize,
+                       int lodLevel) const;
+    float chunkDistanceSquared(const ChunkKey &key, const sf::Vector2f &point) const;
+    void scheduleChunkRequests(const sf::Vector2f &cameraCenter);
+    bool finishChunkRequest(const ChunkKey &key, const CancellationToken &cancelled);
+    int selectLodLevel(const sf::Vector2f &viewSize, float chunkWidth, float chunkHeight) const;
     bool requiresFullReload(const WorldGenParams &currentParams,
                             const WorldGenParams &newParams) const;
     void startSmoothRegeneration(const WorldGenParams &params);
 
-    struct PendingChunkUpdate {
-        sf::Vector2i chunkGridPosition;
-        entt::entity entity;
-        std::future<GeneratedChunkData> future;
-        std::size_t generationId;
-    };
-
     // Member Variables
     entt::registry& _registry;
     EventBus& _eventBus;
     WorldGenerationSystem& _worldGenSystem;
+    WorldRaster& _worldRaster;
     Camera& _camera;
     ThreadPool& _threadPool;
 
-    std::map<sf::Vector2i, entt::entity, Vector2iCompare> _activeChunks;
-    std::set<sf::Vector2i, Vector2iCompare> _chunksBeingLoaded;
-    std::vector<std::future<GeneratedChunkData>> _chunkLoadFutures;
+    ChunkGrid<ChunkSlot> _chunkIndex;
+    std::size_t _activeChunkCount = 0;
+    std::size_t _loadingChunkCount = 0;
+    // Chunks on screen and ahead of the camera as of the last update. Visibility changes
+    // are applied as the difference between the old and new rects.
+    ChunkRect _requiredRect;
+    ChunkRect _prefetchRect;
+    // Wanted chunks that are absent and waiting for an in-flight slot.
+    std::vector<ChunkKey> _missingChunks;
+    // Set when chunks outside the wanted rects may remain, e.g. the previous LOD level.
+    bool _sweepPending = false;
+    int _currentLodLevel = 0;
 
-    std::mutex _completedChunksMutex;
-    std::queue<GeneratedChunkData> _completedChunks;
+    // Smoothed camera motion used to predict where chunks will be needed next.
+    bool _hasCameraSample = false;
+    sf::Vector2f _lastCameraCenter;
+    sf::Vector2f _lastViewSize;
+    sf::Vector2f _cameraVelocity;
+    float _cameraZoomRate = 0.0f;
+    ChunkStreamingStats _streamingStats;
 
-    std::future<void> _generationFuture;
-    std::vector<PendingChunkUpdate> _pendingChunkUpdates;
+    // Shared with the write-back tasks, which may still be queued on the I/O lane after
+    // the system is destroyed.
+    std::shared_ptr<const ChunkDiskCache> _diskCache;
+    ChunkRetentionCache _retentionCache;
+    std::uint64_t _cacheFingerprint = 0;
+
+    // Cache reads and chunk generation push their results here; update() drains it.
+    CompletionQueue<ChunkCompletion> _completions;
+    // Cache reads and chunk generation use the system; the destructor waits for them.
+    TaskTracker _chunkTasks;
+
+    std::shared_ptr<const WorldGenSnapshot> _snapshot;
     std::size_t _currentGenerationId = 0;
-    bool _performingFullReload = false;
-    bool _smoothRegenPending = false;
+    // Cancelled when the snapshot is replaced, so work for a superseded snapshot stops
+    // between noise fields. Every chunk request's token is a child of it.
+    CancellationToken _generationToken;
+
+    // The newest regeneration request, applied once no other has arrived for
+    // WORLD_REGENERATION_DEBOUNCE_S, so a burst of edits builds only the last params.
+    std::shared_ptr<const WorldGenParams> _pendingRegeneration;
+    float _regenerationDelay = 0.0f;
 
     entt::scoped_connection _regenerateWorldListener;
-    entt::scoped_connection _swapWorldStateListener;
     entt::scoped_connection _immediateRedrawListener;
+    entt::scoped_connection _themeChangedListener;
 };
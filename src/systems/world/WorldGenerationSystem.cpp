@@ -1,10 +1,48 @@
 #include "WorldGenerationSystem.h"
 #include "Logger.h"
+#include "core/Hash.h"
+#include "world/TerrainKernel.h"
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <optional>
 #include <vector>
 
+namespace {
+
+std::uint64_t noiseSignature(int seed, float frequency, FastNoiseLite::NoiseType noiseType,
+                             FastNoiseLite::FractalType fractalType, int octaves,
+                             float lacunarity, float gain) {
+    Fnv1a hash;
+    hash.add(seed);
+    hash.add(frequency);
+    hash.add(noiseType);
+    hash.add(fractalType);
+    hash.add(octaves);
+    hash.add(lacunarity);
+    hash.add(gain);
+    return hash.value();
+}
+
+std::shared_ptr<const NoiseField> findField(const ChunkNoiseFields *fields,
+                                            std::uint64_t signature, std::size_t cellCount) {
+    if (!fields) {
+        return nullptr;
+    }
+    for (const auto &field : fields->layers) {
+        if (field && field->signature == signature && field->values.size() == cellCount) {
+            return field;
+        }
+    }
+    if (fields->distortion && fields->distortion->signature == signature
+        && fields->distortion->values.size() == cellCount) {
+        return fields->distortion;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
 WorldGenerationSystem::WorldGenerationSystem(entt::registry &registry, EventBus &eventBus)
     : _registry(registry), _eventBus(eventBus) {
     LOG_DEBUG("WorldGenerationSystem", "System created.");
@@ -30,12 +68,29 @@ void WorldGenerationSystem::setParams(const WorldGenParams &params) {
     }
     assert(_params.elevation.maxElevation >= 0.0f && "Max elevation must be non-negative.");
     assert(_params.elevation.elevationExponent > 0.0f && "Elevation exponent must be positive.");
+    assert(_params.octaveSplit.maxError >= 0.0f && "Upsampling error bound must be non-negative.");
     configureNoise();
 }
 
 void WorldGenerationSystem::configureNoise() {
-    _noiseGenerators.clear();
-    for (const auto &layer : _params.noiseLayers) {
+    generateContinentShape();
+    auto snapshot = buildSnapshot(_params);
+
+#ifndef NDEBUG
+    validateChunkKernel(*snapshot);
+#endif
+
+    std::lock_guard<std::mutex> lock(_snapshotMutex);
+    snapshot->generationId = ++_lastGenerationId;
+    _snapshot = std::move(snapshot);
+}
+
+std::shared_ptr<WorldGenSnapshot>
+WorldGenerationSystem::buildSnapshot(const WorldGenParams &params) const {
+    auto snapshot = std::make_shared<WorldGenSnapshot>();
+    snapshot->params = params;
+    snapshot->noiseBackend = _noiseBackend;
+    for (const auto &layer : params.noiseLayers) {
         FastNoiseLite noise;
         noise.SetSeed(layer.seed);
         noise.SetFrequency(layer.frequency);
@@ -44,16 +99,38 @@ void WorldGenerationSystem::configureNoise() {
         noise.SetFractalOctaves(layer.octaves);
         noise.SetFractalLacunarity(layer.lacunarity);
         noise.SetFractalGain(layer.gain);
-        _noiseGenerators.push_back(noise);
+        snapshot->noiseGenerators.push_back(noise);
+        std::uint64_t signature =
+            noiseSignature(layer.seed, layer.frequency, layer.noiseType, layer.fractalType,
+                           layer.octaves, layer.lacunarity, layer.gain);
+        if (octaveSplitApplies(params.octaveSplit, layer)) {
+            // Upsampled fields differ from exact ones, so they must not be reused as such.
+            Fnv1a hash;
+            hash.add(signature);
+            hash.add(params.octaveSplit.cutoffFrequency);
+            hash.add(params.octaveSplit.maxError);
+            signature = hash.value();
+        }
+        snapshot->layerSignatures.push_back(signature);
+        snapshot->layerSamplers.push_back(NoisePipeline::select(layer, _noiseBackend));
     }
 
-    _coastlineDistortion.SetSeed(_params.noiseLayers.empty() ? 1337
-                                                             : _params.noiseLayers[0].seed + 2);
-    _coastlineDistortion.SetFrequency(
-        _params.noiseLayers.empty() ? 0.02f : _params.noiseLayers[0].frequency * 4.0f);
-    _coastlineDistortion.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    const int distortionSeed = params.noiseLayers.empty() ? 1337 : params.noiseLayers[0].seed + 2;
+    const float distortionFrequency =
+        params.noiseLayers.empty() ? 0.02f : params.noiseLayers[0].frequency * 4.0f;
+    snapshot->coastlineDistortion.SetSeed(distortionSeed);
+    snapshot->coastlineDistortion.SetFrequency(distortionFrequency);
+    snapshot->coastlineDistortion.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    // FastNoiseLite's defaults for the settings not overridden above.
+    snapshot->coastlineDistortionSignature =
+        noiseSignature(distortionSeed, distortionFrequency, FastNoiseLite::NoiseType_Perlin,
+                       FastNoiseLite::FractalType_None, 3, 2.0f, 0.5f);
+    return snapshot;
+}
 
-    generateContinentShape();
+std::shared_ptr<const WorldGenSnapshot> WorldGenerationSystem::getSnapshot() const {
+    std::lock_guard<std::mutex> lock(_snapshotMutex);
+    return _snapshot;
 }
 
 void WorldGenerationSystem::generateContinentShape() {
@@ -90,42 +167,180 @@ sf::Vector2f WorldGenerationSystem::getWorldSize() {
     return {worldWidth, worldHeight};
 }
 
+GeneratedChunkData WorldGenerationSystem::generateChunkData(const sf::Vector2i &chunkGridPosition,
+                                                            int lodLevel) const {
+    return generateChunkData(*getSnapshot(), chunkGridPosition, lodLevel);
+}
+
 GeneratedChunkData
-WorldGenerationSystem::generateChunkData(const sf::Vector2i &chunkGridPosition) const {
-    // Use _params directly
-    const int chunkCellSizeX = static_cast<int>(_params.chunkDimensionsInCells.x);
-    const int chunkCellSizeY = static_cast<int>(_params.chunkDimensionsInCells.y);
-    const int totalCells = chunkCellSizeX * chunkCellSizeY;
+WorldGenerationSystem::generateChunkData(const WorldGenSnapshot &snapshot,
+                                         const sf::Vector2i &chunkGridPosition, int lodLevel,
+                                         std::shared_ptr<const ChunkNoiseFields> previousFields,
+                                         const CancellationToken &cancel) {
+    const WorldGenParams &params = snapshot.params;
+    TerrainKernel::ChunkLattice lattice;
+    lattice.cellsX = static_cast<int>(params.chunkDimensionsInCells.x);
+    lattice.cellsY = static_cast<int>(params.chunkDimensionsInCells.y);
+    lattice.cellStep = 1 << lodLevel;
+    lattice.firstCellX = chunkGridPosition.x * lattice.cellsX * lattice.cellStep;
+    lattice.firstCellY = chunkGridPosition.y * lattice.cellsY * lattice.cellStep;
+    lattice.cellSize = params.cellSize;
+    const size_t totalCells = static_cast<size_t>(lattice.cellCount());
 
     GeneratedChunkData chunkData;
     chunkData.chunkGridPosition = chunkGridPosition;
-    chunkData.cells.resize(totalCells);
-    chunkData.elevations.resize(totalCells);
+    chunkData.lodLevel = lodLevel;
+
+    const TerrainKernel::ShapeParams shape = TerrainKernel::makeShapeParams(params);
+    if (TerrainKernel::isUniformWater(lattice, shape)) {
+        chunkData.cells.assign(totalCells, TerrainType::WATER);
+        chunkData.elevations.assign(totalCells, params.elevation.maxElevation);
+        return chunkData;
+    }
+
+    // Reuse any field whose generator settings are unchanged; only new or edited layers
+    // pay for noise evaluation. Layers use their snapshot sampler; distortion has none.
+    auto sampleField = [&](const FastNoiseLite &noise, std::optional<size_t> layer,
+                           std::uint64_t signature) {
+        if (auto cached = findField(previousFields.get(), signature, totalCells)) {
+            return cached;
+        }
+        auto field = std::make_shared<NoiseField>();
+        field->signature = signature;
+        field->values.resize(totalCells);
+        if (layer) {
+            snapshot.layerSamplers[*layer](noise, params.noiseLayers[*layer], params.octaveSplit,
+                                           lattice, field->values.data());
+        } else {
+            TerrainKernel::sampleNoiseField(noise, lattice, field->values.data());
+        }
+        return std::shared_ptr<const NoiseField>(std::move(field));
+    };
+
+    auto fields = std::make_shared<ChunkNoiseFields>();
+    const size_t layerCount = snapshot.noiseGenerators.size();
+    std::vector<const float *> layerFields(layerCount);
+    std::vector<float> layerWeights(layerCount);
+    fields->layers.reserve(layerCount);
+    for (size_t i = 0; i < layerCount; ++i) {
+        if (cancel.isCancelled()) {
+            return chunkData;
+        }
+        fields->layers.push_back(
+            sampleField(snapshot.noiseGenerators[i], i, snapshot.layerSignatures[i]));
+        layerFields[i] = fields->layers.back()->values.data();
+        layerWeights[i] = params.noiseLayers[i].weight;
+    }
+
+    if (cancel.isCancelled()) {
+        return chunkData;
+    }
+    const float *distortionField = nullptr;
+    if (params.coastlineDistortionStrength > 0.0f) {
+        fields->distortion =
+            sampleField(snapshot.coastlineDistortion, std::nullopt,
+                        snapshot.coastlineDistortionSignature);
+        distortionField = fields->distortion->values.data();
+    }
+
+    std::vector<TerrainType> terrain(totalCells);
+    std::vector<float> elevations(totalCells);
+    TerrainKernel::combineFields(lattice, shape, layerFields.data(), layerWeights.data(),
+                                 layerCount, distortionField, terrain.data(), elevations.data());
+    chunkData.cells.assign(terrain.data(), totalCells);
+    chunkData.elevations.assign(elevations.data(), totalCells, params.elevation.maxElevation);
 
+    chunkData.noiseFields = std::move(fields);
+    return chunkData;
+}
+
+#ifndef NDEBUG
+void WorldGenerationSystem::validateChunkKernel(const WorldGenSnapshot &snapshot) {
+    const WorldGenParams &params = snapshot.params;
+    // Check the chunk at the continent centre, where land and coastline are most likely.
+    const sf::Vector2i chunkGridPosition = {params.worldDimensionsInChunks.x / 2,
+                                            params.worldDimensionsInChunks.y / 2};
+    const GeneratedChunkData chunkData = generateChunkData(snapshot, chunkGridPosition);
+
+    const int chunkCellSizeX = static_cast<int>(params.chunkDimensionsInCells.x);
+    const int chunkCellSizeY = static_cast<int>(params.chunkDimensionsInCells.y);
+    const float maxElevation = std::max(0.0f, params.elevation.maxElevation);
+
+    int typeMismatches = 0;
+    float maxError = 0.0f;
     for (int y = 0; y < chunkCellSizeY; ++y) {
         for (int x = 0; x < chunkCellSizeX; ++x) {
             int cellIndex = y * chunkCellSizeX + x;
             float worldX =
-                static_cast<float>((chunkGridPosition.x * chunkCellSizeX) + x) * _params.cellSize;
+                static_cast<float>((chunkGridPosition.x * chunkCellSizeX) + x) * params.cellSize;
             float worldY =
-                static_cast<float>((chunkGridPosition.y * chunkCellSizeY) + y) * _params.cellSize;
-
-            TerrainSample sample = sampleTerrain(worldX, worldY);
-            chunkData.cells[cellIndex] = sample.terrainType;
-            chunkData.elevations[cellIndex] = sample.elevation;
+                static_cast<float>((chunkGridPosition.y * chunkCellSizeY) + y) * params.cellSize;
+
+            TerrainSample sample = sampleTerrain(snapshot, worldX, worldY);
+            if (sample.terrainType != chunkData.cells[cellIndex]) {
+                ++typeMismatches;
+            }
+            if (maxElevation > 0.0f) {
+                float error =
+                    std::abs(sample.elevation - chunkData.elevations[cellIndex]) / maxElevation;
+                maxError = std::max(maxError, error);
+            }
         }
     }
 
-    return chunkData;
+    LOG_DEBUG("WorldGenerationSystem",
+              "Chunk kernel check: %d terrain mismatches, max normalized elevation error %g.",
+              typeMismatches, maxError);
+
+    // Upsampled octaves may move cells near the land threshold, so check those layers'
+    // noise against its error bound instead of the terrain against sampleTerrain.
+    TerrainKernel::ChunkLattice lattice;
+    lattice.cellsX = chunkCellSizeX;
+    lattice.cellsY = chunkCellSizeY;
+    lattice.firstCellX = chunkGridPosition.x * chunkCellSizeX;
+    lattice.firstCellY = chunkGridPosition.y * chunkCellSizeY;
+    lattice.cellSize = params.cellSize;
+    bool upsampled = false;
+    for (size_t i = 0; i < params.noiseLayers.size(); ++i) {
+        if (NoisePipeline::planOctaveSplit(params.noiseLayers[i], params.octaveSplit, lattice)
+                .coarseOctaves
+            == 0) {
+            continue;
+        }
+        upsampled = true;
+        if (!chunkData.noiseFields) {
+            continue;
+        }
+        std::vector<float> exact(static_cast<size_t>(lattice.cellCount()));
+        TerrainKernel::sampleNoiseField(snapshot.noiseGenerators[i], lattice, exact.data());
+        const std::vector<float> &values = chunkData.noiseFields->layers[i]->values;
+        float noiseError = 0.0f;
+        for (size_t cell = 0; cell < exact.size(); ++cell) {
+            noiseError = std::max(noiseError, std::abs(values[cell] - exact[cell]));
+        }
+        LOG_DEBUG("WorldGenerationSystem", "Layer '%s' upsampling error %g (bound %g).",
+                  params.noiseLayers[i].name.c_str(), noiseError, params.octaveSplit.maxError);
+        assert(noiseError <= params.octaveSplit.maxError
+               && "Upsampled octaves exceeded their error bound.");
+    }
+    if (upsampled) {
+        return;
+    }
+    assert(typeMismatches == 0 && "Chunk kernel terrain disagrees with sampleTerrain.");
+    assert(maxError <= TerrainKernel::NORMALIZED_ELEVATION_TOLERANCE
+           && "Chunk kernel elevation drifted from sampleTerrain.");
 }
+#endif
 
 WorldGenerationSystem::TerrainSample
-WorldGenerationSystem::sampleTerrain(float worldX, float worldY) const {
+WorldGenerationSystem::sampleTerrain(const WorldGenSnapshot &snapshot, float worldX,
+                                     float worldY) {
+    const WorldGenParams &params = snapshot.params;
     sf::Vector2f worldSize = {
-        static_cast<float>(_params.worldDimensionsInChunks.x * _params.chunkDimensionsInCells.x)
-            * _params.cellSize,
-        static_cast<float>(_params.worldDimensionsInChunks.y * _params.chunkDimensionsInCells.y)
-            * _params.cellSize};
+        static_cast<float>(params.worldDimensionsInChunks.x * params.chunkDimensionsInCells.x)
+            * params.cellSize,
+        static_cast<float>(params.worldDimensionsInChunks.y * params.chunkDimensionsInCells.y)
+            * params.cellSize};
     sf::Vector2f center = worldSize / 2.0f;
 
     float dx = center.x - worldX;
@@ -135,17 +350,17 @@ WorldGenerationSystem::sampleTerrain(float worldX, float worldY) const {
     float maxDistance = std::min(worldSize.x, worldSize.y) / 2.5f;
     float falloff = 1.0f - std::min(1.0f, distance / maxDistance);
 
-    float noiseX = worldX / _params.cellSize;
-    float noiseY = worldY / _params.cellSize;
+    float noiseX = worldX / params.cellSize;
+    float noiseY = worldY / params.cellSize;
 
     float combinedNoise = 0.0f;
     float totalWeight = 0.0f;
 
-    for (size_t i = 0; i < _noiseGenerators.size(); ++i) {
-        float noiseValue = _noiseGenerators[i].GetNoise(noiseX, noiseY);
+    for (size_t i = 0; i < snapshot.noiseGenerators.size(); ++i) {
+        float noiseValue = snapshot.noiseGenerators[i].GetNoise(noiseX, noiseY);
         noiseValue = (noiseValue + 1.0f) / 2.0f; // Remap from [-1, 1] to [0, 1]
-        combinedNoise += noiseValue * _params.noiseLayers[i].weight;
-        totalWeight += _params.noiseLayers[i].weight;
+        combinedNoise += noiseValue * params.noiseLayers[i].weight;
+        totalWeight += params.noiseLayers[i].weight;
     }
 
     if (totalWeight > 0) {
@@ -154,10 +369,10 @@ WorldGenerationSystem::sampleTerrain(float worldX, float worldY) const {
 
     float finalValue = combinedNoise * falloff;
 
-    float distortedLandThreshold = _params.landThreshold;
-    if (_params.coastlineDistortionStrength > 0.0f) {
-        float distortion =
-            _coastlineDistortion.GetNoise(noiseX, noiseY) * _params.coastlineDistortionStrength;
+    float distortedLandThreshold = params.landThreshold;
+    if (params.coastlineDistortionStrength > 0.0f) {
+        float distortion = snapshot.coastlineDistortion.GetNoise(noiseX, noiseY)
+                           * params.coastlineDistortionStrength;
         distortedLandThreshold += distortion;
     }
 
@@ -169,9 +384,9 @@ WorldGenerationSystem::sampleTerrain(float worldX, float worldY) const {
         float denominator = std::max(0.0001f, 1.0f - distortedLandThreshold);
         float ratio = (finalValue - distortedLandThreshold) / denominator;
         ratio = std::clamp(ratio, 0.0f, 1.0f);
-        float exponent = std::max(0.01f, _params.elevation.elevationExponent);
+        float exponent = std::max(0.01f, params.elevation.elevationExponent);
         normalizedElevation = std::pow(ratio, exponent);
-        float maxElevation = std::max(0.0f, _params.elevation.maxElevation);
+        float maxElevation = std::max(0.0f, params.elevation.maxElevation);
         elevation = normalizedElevation * maxElevation;
     }
 
@@ -179,13 +394,29 @@ WorldGenerationSystem::sampleTerrain(float worldX, float worldY) const {
 }
 
 TerrainType WorldGenerationSystem::getTerrainTypeAt(float worldX, float worldY) const {
-    return sampleTerrain(worldX, worldY).terrainType;
+    return sampleTerrain(*getSnapshot(), worldX, worldY).terrainType;
 }
 
 float WorldGenerationSystem::getElevationAt(float worldX, float worldY) const {
-    return sampleTerrain(worldX, worldY).elevation;
+    return sampleTerrain(*getSnapshot(), worldX, worldY).elevation;
 }
 
 void WorldGenerationSystem::regenerate(const WorldGenParams &params) {
     setParams(params);
 }
+
+bool WorldGenerationSystem::octaveSplitApplies(const OctaveSplitParams &split,
+                                               const NoiseLayer &layer) const {
+    return split.enabled && _noiseBackend == NoisePipeline::Backend::Specialized
+           && NoisePipeline::supportsOctaveSplit(layer);
+}
+
+void WorldGenerationSystem::setNoiseBackend(NoisePipeline::Backend backend) {
+    if (backend == _noiseBackend) {
+        return;
+    }
+    _noiseBackend = backend;
+    LOG_INFO("WorldGenerationSystem", "Noise backend set to %s.",
+             NoisePipeline::backendName(backend));
+    configureNoise();
+}
@@ -1,29 +1,76 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "FastNoiseLite.h"
 #include "components/WorldComponents.h"
+#include "core/CancellationToken.h"
 #include "event/EventBus.h"
 #include "event/InputEvents.h"
+#include "world/NoisePipeline.h"
 #include "world/WorldData.h"
 
+// Immutable inputs for one generation pass. Workers hold the snapshot they were started
+// with, so the live parameters can be edited or replaced underneath them at any time.
+struct WorldGenSnapshot {
+    std::size_t generationId = 0;
+    WorldGenParams params;
+    NoisePipeline::Backend noiseBackend = NoisePipeline::Backend::Specialized;
+    std::vector<FastNoiseLite> noiseGenerators;
+    std::vector<std::uint64_t> layerSignatures;
+    // Resolved from each layer's settings and the backend when the snapshot is published.
+    std::vector<NoisePipeline::FieldSampler> layerSamplers;
+    FastNoiseLite coastlineDistortion;
+    std::uint64_t coastlineDistortionSignature = 0;
+};
+
 class WorldGenerationSystem {
 public:
     WorldGenerationSystem(entt::registry &registry, EventBus &eventBus);
     ~WorldGenerationSystem();
     void init();
 
+    // Publishes a new snapshot built from the current params.
     void configureNoise();
 
-    GeneratedChunkData generateChunkData(const sf::Vector2i &chunkGridPosition) const;
+    // Builds a snapshot of `params` without publishing it. Its generationId is 0, so it never
+    // matches chunks or rasters generated from published snapshots.
+    std::shared_ptr<WorldGenSnapshot> buildSnapshot(const WorldGenParams &params) const;
+
+    // The most recently published snapshot. Safe to call from any thread.
+    std::shared_ptr<const WorldGenSnapshot> getSnapshot() const;
+
+    // Generates a chunk. Layer fields in `previousFields` whose generator settings are
+    // unchanged are reused instead of re-evaluating their noise. Once `cancel` is cancelled
+    // the chunk is abandoned between fields and returned without cells.
+    static GeneratedChunkData
+    generateChunkData(const WorldGenSnapshot &snapshot, const sf::Vector2i &chunkGridPosition,
+                      int lodLevel = 0,
+                      std::shared_ptr<const ChunkNoiseFields> previousFields = nullptr,
+                      const CancellationToken &cancel = {});
+    GeneratedChunkData generateChunkData(const sf::Vector2i &chunkGridPosition,
+                                         int lodLevel = 0) const;
 
     TerrainType getTerrainTypeAt(float worldX, float worldY) const;
     float getElevationAt(float worldX, float worldY) const;
 
     sf::Vector2f getWorldSize();
 
+    struct TerrainSample {
+        TerrainType terrainType;
+        float normalizedElevation;
+        float elevation;
+    };
+
+    // Evaluates the full noise stack at one point. Prefer TerrainQueryService, which reads
+    // generated chunk data where it exists.
+    static TerrainSample sampleTerrain(const WorldGenSnapshot &snapshot, float worldX,
+                                       float worldY);
+
     entt::registry &getRegistry() noexcept { return _registry; }
 
     const WorldGenParams &getParams() const noexcept { return _params; }
@@ -32,22 +79,30 @@ public:
 
     void regenerate(const WorldGenParams &params);
 
+    // Publishes a new snapshot whose layers sample through `backend`.
+    void setNoiseBackend(NoisePipeline::Backend backend);
+    NoisePipeline::Backend getNoiseBackend() const noexcept { return _noiseBackend; }
+
 private:
     entt::registry &_registry;
     EventBus &_eventBus;
 
-    std::vector<FastNoiseLite> _noiseGenerators;
-    FastNoiseLite _coastlineDistortion;
+    // Main-thread working copy; the UI edits it in place. Workers never read it.
     WorldGenParams _params;
+    NoisePipeline::Backend _noiseBackend = NoisePipeline::Backend::Specialized;
+
+    mutable std::mutex _snapshotMutex;
+    std::shared_ptr<const WorldGenSnapshot> _snapshot;
+    std::size_t _lastGenerationId = 0;
 
     void generateContinentShape();
-    struct TerrainSample {
-        TerrainType terrainType;
-        float normalizedElevation;
-        float elevation;
-    };
+    // True when `layer` is sampled with its low octaves upsampled under `split`.
+    bool octaveSplitApplies(const OctaveSplitParams &split, const NoiseLayer &layer) const;
 
-    TerrainSample sampleTerrain(float worldX, float worldY) const;
+#ifndef NDEBUG
+    // Compares one generated chunk against per-cell sampleTerrain results.
+    static void validateChunkKernel(const WorldGenSnapshot &snapshot);
+#endif
 
     entt::connection _regenerateWorldListener;
 };
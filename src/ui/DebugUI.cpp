@@ -3,16 +3,21 @@
 #include "Logger.h"
 #include "app/GameState.h"
 #include "components/GameLogicComponents.h"
+#include "core/CpuFeatures.h"
 #include "core/PerformanceMonitor.h"
 #include "imgui.h"
 #include "render/Camera.h"
 #include "render/ColorManager.h"
+#include "systems/world/WorldGenerationSystem.h"
+#include "world/SimdKernels.h"
+#include <algorithm>
 
 DebugUI::DebugUI(entt::registry &registry, PerformanceMonitor &performanceMonitor, Camera &camera,
                  GameState &gameState, ColorManager &colorManager, EventBus &eventBus,
-                 sf::RenderWindow &window)
+                 sf::RenderWindow &window, WorldGenerationSystem &worldGenerationSystem)
     : _registry(registry), _performanceMonitor(performanceMonitor), _camera(camera),
-      _gameState(gameState), _colorManager(colorManager), _window(window) {
+      _gameState(gameState), _colorManager(colorManager), _window(window),
+      _worldGenerationSystem(worldGenerationSystem) {
     _themeChangedConnection =
         eventBus.sink<ThemeChangedEvent>().connect<&DebugUI::onThemeChanged>(this);
     LOG_DEBUG("DebugUI", "DebugUI instance created.");
@@ -22,9 +27,10 @@ DebugUI::~DebugUI() {
     LOG_DEBUG("DebugUI", "DebugUI instance destroyed.");
 }
 
-void DebugUI::draw(sf::Time deltaTime, const CityPlacementDebugInfo &cityPlacementDebugInfo) {
+void DebugUI::draw(sf::Time deltaTime, const CityPlacementDebugInfo &cityPlacementDebugInfo,
+                   const ChunkStreamingStats &chunkStreamingStats) {
     drawTimeControlWindow();
-    drawProfilingWindow(deltaTime, cityPlacementDebugInfo);
+    drawProfilingWindow(deltaTime, cityPlacementDebugInfo, chunkStreamingStats);
     drawSettingsWindow();
 }
 
@@ -37,7 +43,8 @@ void DebugUI::onThemeChanged(const ThemeChangedEvent &event) {
 }
 
 void DebugUI::drawProfilingWindow(sf::Time deltaTime,
-                                  const CityPlacementDebugInfo &cityPlacementDebugInfo) {
+                                  const CityPlacementDebugInfo &cityPlacementDebugInfo,
+                                  const ChunkStreamingStats &chunkStreamingStats) {
     const float windowPadding = Constants::UI_WINDOW_PADDING;
     ImGuiWindowFlags size_flags =
         ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_AlwaysAutoResize;
@@ -55,6 +62,9 @@ void DebugUI::drawProfilingWindow(sf::Time deltaTime,
 
         drawPerformanceGraphs();
         drawCityPlacementInfo(cityPlacementDebugInfo);
+        drawChunkStreamingInfo(chunkStreamingStats);
+        drawNoiseBenchmark();
+        drawThreadPoolBenchmark();
         ImGui::End();
     }
 }
@@ -88,6 +98,163 @@ void DebugUI::drawCityPlacementInfo(const CityPlacementDebugInfo &cityPlacementD
     }
 }
 
+void DebugUI::drawChunkStreamingInfo(const ChunkStreamingStats &chunkStreamingStats) {
+    if (ImGui::CollapsingHeader("Chunk Streaming")) {
+        ImGui::Text("Active Chunks: %zu", chunkStreamingStats.activeChunks);
+        ImGui::Text("Requests In Flight: %zu", chunkStreamingStats.requestsInFlight);
+        ImGui::Text("Prefetches Requested: %zu", chunkStreamingStats.prefetchRequested);
+        ImGui::Text("Prefetch Hits: %zu", chunkStreamingStats.prefetchHits);
+        ImGui::Text("Prefetch Wasted: %zu", chunkStreamingStats.prefetchWasted);
+        const std::size_t resolved =
+            chunkStreamingStats.prefetchHits + chunkStreamingStats.prefetchWasted;
+        if (resolved > 0) {
+            ImGui::Text("Prefetch Hit Rate: %.1f%%",
+                        100.0f * static_cast<float>(chunkStreamingStats.prefetchHits)
+                            / static_cast<float>(resolved));
+        }
+
+        const ChunkRetentionStats &retention = chunkStreamingStats.retention;
+        ImGui::Text("Retained Chunks: %zu (%.1f MiB)", retention.retainedChunks,
+                    static_cast<float>(retention.retainedBytes) / (1024.0f * 1024.0f));
+        ImGui::Text("Retention Hits: %zu", retention.hits);
+        ImGui::Text("Retention Misses: %zu", retention.misses);
+        ImGui::Text("Retention Evictions: %zu", retention.evictions);
+    }
+}
+
+void DebugUI::drawNoiseBenchmark() {
+    if (ImGui::CollapsingHeader("Noise Benchmark")) {
+        static const std::string cpuFeatureNames = cpuFeatures().describe();
+        ImGui::Text("CPU Features: %s", cpuFeatureNames.c_str());
+        ImGui::Text("Numeric Kernels: %s", SimdKernels::active().name);
+
+        bool specialized =
+            _worldGenerationSystem.getNoiseBackend() == NoisePipeline::Backend::Specialized;
+        if (ImGui::Checkbox("Specialized Noise Pipeline", &specialized)) {
+            _worldGenerationSystem.setNoiseBackend(specialized
+                                                       ? NoisePipeline::Backend::Specialized
+                                                       : NoisePipeline::Backend::PerSample);
+        }
+
+        if (ImGui::Button("Run Pipeline Benchmark")) {
+            runPipelineBenchmark();
+        }
+        for (const auto &entry : _pipelineBenchmarks) {
+            const NoisePipeline::BenchmarkResult &result = entry.result;
+            if (!entry.specialized) {
+                ImGui::Text("%s: no specialization", entry.layerName.c_str());
+                continue;
+            }
+            ImGui::Text("%s: %.2f ms -> %.2f ms (%.1fx), max difference %g",
+                        entry.layerName.c_str(), result.perSampleMs, result.specializedMs,
+                        result.perSampleMs / std::max(result.specializedMs, 1e-6),
+                        result.maxDifference);
+            if (result.splitPlan.coarseOctaves > 0) {
+                ImGui::Text("  Octave Split (%d upsampled every %d cells): %.2f ms (%.1fx), "
+                            "max difference %g",
+                            result.splitPlan.coarseOctaves, result.splitPlan.spacing,
+                            result.splitMs, result.perSampleMs / std::max(result.splitMs, 1e-6),
+                            result.splitMaxDifference);
+            }
+        }
+
+        ImGui::Separator();
+        if (ImGui::Button("Run Cellular Benchmark")) {
+            runNoiseBenchmark();
+        }
+        if (_noiseBenchmarkRun && _noiseBenchmarks.empty()) {
+            ImGui::Text("No cellular layers to benchmark.");
+        }
+        for (const auto &entry : _noiseBenchmarks) {
+            const CellularNoise::BenchmarkResult &result = entry.result;
+            ImGui::Text("%s (%d samples)", entry.layerName.c_str(), result.samples);
+            ImGui::Text("  Per-Sample: %.2f ms", result.perSampleMs);
+            ImGui::Text("  Scalar: %.2f ms (%.1fx)", result.scalarMs,
+                        result.perSampleMs / std::max(result.scalarMs, 1e-6));
+            ImGui::Text("  SIMD: %.2f ms (%.1fx)", result.wideMs,
+                        result.perSampleMs / std::max(result.wideMs, 1e-6));
+            ImGui::Text("  Max Difference: %g", result.maxDifference);
+        }
+    }
+}
+
+void DebugUI::runNoiseBenchmark() {
+    const auto snapshot = _worldGenerationSystem.getSnapshot();
+    const auto &layers = snapshot->params.noiseLayers;
+    _noiseBenchmarks.clear();
+    _noiseBenchmarkRun = true;
+    for (std::size_t i = 0; i < layers.size() && i < snapshot->noiseGenerators.size(); ++i) {
+        if (!CellularNoise::supports(layers[i])) {
+            continue;
+        }
+        const auto result = CellularNoise::benchmark(snapshot->noiseGenerators[i], layers[i],
+                                                     Constants::NOISE_BENCHMARK_CELLS,
+                                                     Constants::NOISE_BENCHMARK_REPETITIONS);
+        LOG_INFO("DebugUI",
+                 "Cellular benchmark '%s': per-sample %.2f ms, scalar %.2f ms, SIMD %.2f ms, "
+                 "max difference %g.",
+                 layers[i].name.c_str(), result.perSampleMs, result.scalarMs, result.wideMs,
+                 result.maxDifference);
+        _noiseBenchmarks.push_back({layers[i].name, result});
+    }
+}
+
+void DebugUI::runPipelineBenchmark() {
+    const auto snapshot = _worldGenerationSystem.getSnapshot();
+    const auto &layers = snapshot->params.noiseLayers;
+    _pipelineBenchmarks.clear();
+    // Time the split with the current bounds even while it is switched off.
+    OctaveSplitParams split = snapshot->params.octaveSplit;
+    split.enabled = true;
+    for (std::size_t i = 0; i < layers.size() && i < snapshot->noiseGenerators.size(); ++i) {
+        PipelineBenchmarkEntry entry{layers[i].name, NoisePipeline::isSpecialized(layers[i]), {}};
+        if (entry.specialized) {
+            entry.result = NoisePipeline::benchmark(snapshot->noiseGenerators[i], layers[i], split,
+                                                    Constants::NOISE_BENCHMARK_CELLS,
+                                                    Constants::NOISE_BENCHMARK_REPETITIONS);
+            LOG_INFO("DebugUI",
+                     "Pipeline benchmark '%s': per-sample %.2f ms, specialized %.2f ms, "
+                     "max difference %g; octave split %.2f ms, max difference %g.",
+                     layers[i].name.c_str(), entry.result.perSampleMs,
+                     entry.result.specializedMs, entry.result.maxDifference,
+                     entry.result.splitMs, entry.result.splitMaxDifference);
+        }
+        _pipelineBenchmarks.push_back(std::move(entry));
+    }
+}
+
+void DebugUI::drawThreadPoolBenchmark() {
+    if (ImGui::CollapsingHeader("Thread Pool Benchmark")) {
+        if (ImGui::Button("Run Thread Pool Benchmark")) {
+            _threadPoolBenchmarks = ThreadPoolBenchmark::run(
+                Constants::THREAD_POOL_BENCHMARK_MAX_THREADS,
+                Constants::THREAD_POOL_BENCHMARK_ROOT_TASKS,
+                Constants::THREAD_POOL_BENCHMARK_CHILD_TASKS,
+                Constants::THREAD_POOL_BENCHMARK_SUBMITTED_TASKS,
+                Constants::THREAD_POOL_BENCHMARK_REPETITIONS);
+            for (const auto &result : _threadPoolBenchmarks) {
+                LOG_INFO("DebugUI",
+                         "Thread pool benchmark, %d threads, %d tasks: shared queue %.2f ms, "
+                         "work stealing %.2f ms.",
+                         result.threads, result.tasks, result.sharedQueueMs,
+                         result.workStealingMs);
+                LOG_INFO("DebugUI",
+                         "Thread pool submission, %d threads, %d tasks: wrapped %.2f ms, "
+                         "enqueue %.2f ms, post %.2f ms.",
+                         result.threads, result.submittedTasks, result.wrappedSubmitMs,
+                         result.enqueueSubmitMs, result.postSubmitMs);
+            }
+        }
+        for (const auto &result : _threadPoolBenchmarks) {
+            ImGui::Text("%2d threads: shared queue %.2f ms, work stealing %.2f ms (%.1fx)",
+                        result.threads, result.sharedQueueMs, result.workStealingMs,
+                        result.sharedQueueMs / std::max(result.workStealingMs, 1e-6));
+            ImGui::Text("    submitting: wrapped %.2f ms, enqueue %.2f ms, post %.2f ms",
+                        result.wrappedSubmitMs, result.enqueueSubmitMs, result.postSubmitMs);
+        }
+    }
+}
+
 void DebugUI::drawTimeControlWindow() {
     const float windowPadding = Constants::UI_WINDOW_PADDING;
     ImGuiWindowFlags flags =
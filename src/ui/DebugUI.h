@@ -3,32 +3,46 @@
 #include "event/EventBus.h"
 #include "event/UIEvents.h"
 #include "systems/gameplay/CityPlacementSystem.h"
+#include "core/ThreadPoolBenchmark.h"
+#include "systems/world/ChunkManagerSystem.h"
+#include "world/CellularNoise.h"
+#include "world/NoisePipeline.h"
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/System/Time.hpp>
+#include <string>
+#include <vector>
 
 class PerformanceMonitor;
 class Camera;
 class GameState;
 class ColorManager;
+class WorldGenerationSystem;
 
 class DebugUI {
 public:
     DebugUI(entt::registry &registry, PerformanceMonitor &performanceMonitor, Camera &camera,
             GameState &gameState, ColorManager &colorManager, EventBus &eventBus,
-            sf::RenderWindow &window);
+            sf::RenderWindow &window, WorldGenerationSystem &worldGenerationSystem);
     ~DebugUI();
 
-    void draw(sf::Time deltaTime, const CityPlacementDebugInfo &cityPlacementDebugInfo);
+    void draw(sf::Time deltaTime, const CityPlacementDebugInfo &cityPlacementDebugInfo,
+              const ChunkStreamingStats &chunkStreamingStats);
 
 private:
     void onThemeChanged(const ThemeChangedEvent &event);
 
     void drawProfilingWindow(sf::Time deltaTime,
-                             const CityPlacementDebugInfo &cityPlacementDebugInfo);
+                             const CityPlacementDebugInfo &cityPlacementDebugInfo,
+                             const ChunkStreamingStats &chunkStreamingStats);
     void drawTimeControlWindow();
     void drawSettingsWindow();
     void drawPerformanceGraphs();
     void drawCityPlacementInfo(const CityPlacementDebugInfo &cityPlacementDebugInfo);
+    void drawChunkStreamingInfo(const ChunkStreamingStats &chunkStreamingStats);
+    void drawNoiseBenchmark();
+    void runNoiseBenchmark();
+    void runPipelineBenchmark();
+    void drawThreadPoolBenchmark();
 
     PerformanceMonitor &_performanceMonitor;
     Camera &_camera;
@@ -36,6 +50,22 @@ private:
     ColorManager &_colorManager;
     sf::RenderWindow &_window;
     entt::registry &_registry;
+    WorldGenerationSystem &_worldGenerationSystem;
+
+    struct NoiseBenchmarkEntry {
+        std::string layerName;
+        CellularNoise::BenchmarkResult result;
+    };
+    std::vector<NoiseBenchmarkEntry> _noiseBenchmarks;
+    bool _noiseBenchmarkRun = false;
+
+    struct PipelineBenchmarkEntry {
+        std::string layerName;
+        bool specialized = false;
+        NoisePipeline::BenchmarkResult result;
+    };
+    std::vector<PipelineBenchmarkEntry> _pipelineBenchmarks;
+    std::vector<ThreadPoolBenchmark::Result> _threadPoolBenchmarks;
 
     entt::scoped_connection _themeChangedConnection;
 };
\ No newline at end of file
@@ -1,19 +1,21 @@
 #include "UIManager.h"
 #include "event/EventBus.h"
 #include "systems/gameplay/CityPlacementSystem.h"
+#include "systems/world/ChunkManagerSystem.h"
 
 UIManager::UIManager(entt::registry &registry, EventBus &eventBus,
                      WorldGenerationSystem &worldGenerationSystem,
                      TerrainRenderSystem &terrainRenderSystem,
                      PerformanceMonitor &performanceMonitor, Camera &camera, GameState &gameState,
                      ColorManager &colorManager, sf::RenderWindow &window,
-                     CityPlacementSystem &cityPlacementSystem)
-    : _cityPlacementSystem(cityPlacementSystem) {
+                     CityPlacementSystem &cityPlacementSystem,
+                     ChunkManagerSystem &chunkManagerSystem, ThreadPool &threadPool)
+    : _cityPlacementSystem(cityPlacementSystem), _chunkManagerSystem(chunkManagerSystem) {
     _infoPanelUI = std::make_unique<InfoPanelUI>(registry, eventBus, gameState);
-    _worldGenSettingsUI =
-        std::make_unique<WorldGenSettingsUI>(eventBus, worldGenerationSystem, terrainRenderSystem);
+    _worldGenSettingsUI = std::make_unique<WorldGenSettingsUI>(eventBus, worldGenerationSystem,
+                                                               terrainRenderSystem, threadPool);
     _debugUI = std::make_unique<DebugUI>(registry, performanceMonitor, camera, gameState,
-                                         colorManager, eventBus, window);
+                                         colorManager, eventBus, window, worldGenerationSystem);
     _interactionUI = std::make_unique<InteractionUI>(gameState, eventBus, window);
 }
 
@@ -25,7 +27,8 @@ void UIManager::draw(sf::Time deltaTime, size_t numStationsInActiveLine,
     _worldGenSettingsUI->draw();
     _infoPanelUI->draw(_worldGenSettingsUI->getBottomY());
     CityPlacementDebugInfo cityPlacementDebugInfo = _cityPlacementSystem.getDebugInfo();
-    _debugUI->draw(deltaTime, cityPlacementDebugInfo);
+    ChunkStreamingStats chunkStreamingStats = _chunkManagerSystem.getStreamingStats();
+    _debugUI->draw(deltaTime, cityPlacementDebugInfo, chunkStreamingStats);
     _interactionUI->draw(numStationsInActiveLine, numPointsInActiveLine, currentSegmentGrade,
                          currentSegmentExceedsGrade);
 }
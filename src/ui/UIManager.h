@@ -17,6 +17,8 @@ class Camera;
 class GameState;
 class ColorManager;
 class CityPlacementSystem;
+class ChunkManagerSystem;
+class ThreadPool;
 namespace sf {
 class RenderWindow;
 }
@@ -27,7 +29,8 @@ public:
               WorldGenerationSystem &worldGenerationSystem,
               TerrainRenderSystem &terrainRenderSystem, PerformanceMonitor &performanceMonitor,
               Camera &camera, GameState &gameState, ColorManager &colorManager,
-              sf::RenderWindow &window, CityPlacementSystem &cityPlacementSystem);
+              sf::RenderWindow &window, CityPlacementSystem &cityPlacementSystem,
+              ChunkManagerSystem &chunkManagerSystem, ThreadPool &threadPool);
     ~UIManager();
 
     void draw(sf::Time deltaTime, size_t numStationsInActiveLine, size_t numPointsInActiveLine,
@@ -40,4 +43,5 @@ private:
     std::unique_ptr<DebugUI> _debugUI;
     std::unique_ptr<InteractionUI> _interactionUI;
     CityPlacementSystem &_cityPlacementSystem;
+    ChunkManagerSystem &_chunkManagerSystem;
 };
@@ -4,9 +4,11 @@
 #include "event/DeletionEvents.h"
 #include "event/InputEvents.h"
 #include "event/UIEvents.h"
+#include "imgui-SFML.h"
 #include "imgui.h"
 #include "systems/rendering/TerrainRenderSystem.h"
 #include "systems/world/WorldGenerationSystem.h"
+#include <SFML/Graphics/Image.hpp>
 #include <cstdlib>
 
 #include <algorithm>
@@ -17,10 +19,11 @@
 
 WorldGenSettingsUI::WorldGenSettingsUI(EventBus &eventBus,
                                        WorldGenerationSystem &worldGenerationSystem,
-                                       TerrainRenderSystem &terrainRenderSystem)
+                                       TerrainRenderSystem &terrainRenderSystem,
+                                       ThreadPool &threadPool)
     : _eventBus(eventBus), _worldGenerationSystem(worldGenerationSystem),
       _terrainRenderSystem(terrainRenderSystem),
-      _defaultParams(worldGenerationSystem.getParams()) {
+      _defaultParams(worldGenerationSystem.getParams()), _preview(threadPool) {
     _shadedReliefEnabled = _terrainRenderSystem.isShadedReliefEnabled();
     _mouseMovedConnection =
         _eventBus.sink<MouseMovedEvent>().connect<&WorldGenSettingsUI::onMouseMoved>(this);
@@ -96,6 +99,8 @@ void WorldGenSettingsUI::draw() {
     bool paramsChanged = false;
     bool gridChanged = false;
 
+    drawPreview(params);
+    ImGui::Separator();
     drawNoiseLayerSettings(params, paramsChanged);
     ImGui::Separator();
     drawWorldGridSettings(params, gridChanged);
@@ -106,10 +111,18 @@ void WorldGenSettingsUI::draw() {
     ImGui::Separator();
     drawActions(params);
 
-    if ((paramsChanged || gridChanged) && _autoRegenerate) {
-        LOG_DEBUG("UI", "Settings changed, auto-regenerating world.");
-        auto paramsCopy = std::make_shared<WorldGenParams>(params);
-        _eventBus.enqueue<RegenerateWorldRequestEvent>({paramsCopy});
+    // The preview follows every change; the world only regenerates once the edit is let go.
+    if (paramsChanged || gridChanged) {
+        _hasUncommittedEdits = true;
+        _preview.request(_worldGenerationSystem.buildSnapshot(params));
+    }
+    if (_hasUncommittedEdits && !ImGui::IsAnyItemActive()) {
+        _hasUncommittedEdits = false;
+        if (_autoRegenerate) {
+            LOG_DEBUG("UI", "Settings committed, auto-regenerating world.");
+            auto paramsCopy = std::make_shared<WorldGenParams>(params);
+            _eventBus.enqueue<RegenerateWorldRequestEvent>({paramsCopy});
+        }
     }
     ImVec2 windowPos = ImGui::GetWindowPos();
     ImVec2 windowSize = ImGui::GetWindowSize();
@@ -118,6 +131,50 @@ void WorldGenSettingsUI::draw() {
     ImGui::End();
 }
 
+void WorldGenSettingsUI::drawPreview(const WorldGenParams &params) {
+    if (!ImGui::CollapsingHeader("World Preview", ImGuiTreeNodeFlags_DefaultOpen)) {
+        return;
+    }
+    if (!_preview.latest() && !_preview.isPending()) {
+        _preview.request(_worldGenerationSystem.buildSnapshot(params));
+    }
+    updatePreviewTexture();
+
+    const auto image = _preview.latest();
+    if (!image || _previewTextureRequest != image->requestId) {
+        ImGui::TextUnformatted("Generating preview...");
+        return;
+    }
+    const float width = ImGui::GetContentRegionAvail().x;
+    const float height =
+        width * static_cast<float>(image->height) / static_cast<float>(image->width);
+    ImGui::Image(_previewTexture, sf::Vector2f(width, height));
+    ImGui::Text("%d x %d, every %d cells, %.1f ms%s", image->width, image->height,
+                image->cellStep, image->milliseconds, _preview.isPending() ? " (updating)" : "");
+}
+
+void WorldGenSettingsUI::updatePreviewTexture() {
+    const auto image = _preview.latest();
+    if (!image || image->requestId == _previewTextureRequest) {
+        return;
+    }
+    sf::Image pixels({static_cast<unsigned int>(image->width),
+                      static_cast<unsigned int>(image->height)});
+    for (int y = 0; y < image->height; ++y) {
+        for (int x = 0; x < image->width; ++x) {
+            const std::size_t index = static_cast<std::size_t>(y) * image->width + x;
+            pixels.setPixel({static_cast<unsigned int>(x), static_cast<unsigned int>(y)},
+                            _terrainRenderSystem.previewColor(
+                                image->terrain[index], image->normalizedElevations[index]));
+        }
+    }
+    _previewTextureRequest = image->requestId;
+    if (!_previewTexture.loadFromImage(pixels)) {
+        LOG_WARN("WorldGenSettingsUI", "Failed to upload %d x %d world preview.", image->width,
+                 image->height);
+    }
+}
+
 void WorldGenSettingsUI::drawNoiseLayerSettings(WorldGenParams &params, bool &paramsChanged) {
     if (ImGui::Button("New Seed")) {
         for (auto &layer : params.noiseLayers) {
@@ -180,6 +237,20 @@ void WorldGenSettingsUI::drawNoiseLayerSettings(WorldGenParams &params, bool &pa
             ImGui::PopID();
         }
     }
+
+    ImGui::Separator();
+    if (ImGui::Checkbox("Upsample Low Octaves", &params.octaveSplit.enabled)) {
+        paramsChanged = true;
+    }
+    if (params.octaveSplit.enabled) {
+        if (sliderFloatWithReset("Octave Cutoff Frequency", &params.octaveSplit.cutoffFrequency,
+                                 _defaultParams.octaveSplit.cutoffFrequency, 0.001f, 0.2f,
+                                 "%.4f"))
+            paramsChanged = true;
+        if (sliderFloatWithReset("Upsampling Error Bound", &params.octaveSplit.maxError,
+                                 _defaultParams.octaveSplit.maxError, 0.0001f, 0.01f, "%.4f"))
+            paramsChanged = true;
+    }
 }
 
 void WorldGenSettingsUI::drawWorldGridSettings(WorldGenParams &params, bool &gridChanged) {
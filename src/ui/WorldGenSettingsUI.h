@@ -2,7 +2,10 @@
 
 #include "components/WorldComponents.h"
 #include "event/EventBus.h"
+#include "world/WorldPreview.h"
+#include <SFML/Graphics/Texture.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <cstdint>
 #include <entt/entt.hpp>
 #include <filesystem>
 #include <string>
@@ -11,17 +14,20 @@ struct MouseMovedEvent;
 
 class WorldGenerationSystem;
 class TerrainRenderSystem;
+class ThreadPool;
 
 class WorldGenSettingsUI {
 public:
     WorldGenSettingsUI(EventBus &eventBus, WorldGenerationSystem &worldGenerationSystem,
-                       TerrainRenderSystem &terrainRenderSystem);
+                       TerrainRenderSystem &terrainRenderSystem, ThreadPool &threadPool);
     ~WorldGenSettingsUI();
 
     void draw();
     float getBottomY() const { return _lastWindowBottomY; }
 
 private:
+    void drawPreview(const WorldGenParams &params);
+    void updatePreviewTexture();
     void drawNoiseLayerSettings(WorldGenParams &params, bool &paramsChanged);
     void drawWorldGridSettings(WorldGenParams &params, bool &gridChanged);
     void drawElevationSettings(WorldGenParams &params, bool &paramsChanged);
@@ -41,6 +47,13 @@ private:
     TerrainRenderSystem &_terrainRenderSystem;
     WorldGenParams _defaultParams;
 
+    WorldPreview _preview;
+    sf::Texture _previewTexture;
+    std::uint64_t _previewTextureRequest = 0;
+    // Set by any edit and cleared once no control is held, so regeneration waits for the
+    // edit to be committed instead of following every step of a slider drag.
+    bool _hasUncommittedEdits = false;
+
     bool _autoRegenerate = false;
     bool _visualizeChunkBorders = false;
     bool _visualizeCellBorders = false;
@@ -0,0 +1,218 @@
+#include "CellularNoise.h"
+#include "world/FastNoiseInternals.h"
+#include "world/NoiseBenchmark.h"
+#include "world/SimdKernels.h"
+#include "world/WorldData.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace CellularNoise {
+
+namespace {
+
+using namespace FastNoiseInternals;
+
+constexpr std::int32_t VECTOR_INDEX_MASK = 255 << 1;
+// FastNoiseLite's 2D jitter scale at its default jitter modifier of 1.
+constexpr float CELLULAR_JITTER = 0.43701595f;
+constexpr float NO_DISTANCE = 1e10f;
+// Sample spacings, in noise cells, up to which the lanes and the shared grid are used.
+constexpr float MAX_LANE_SPACING = 1.0f;
+constexpr float MAX_GRID_SPACING = 3.0f;
+
+// Offset of the jittered feature point in noise cell (x, y) from the cell's corner.
+void featureOffset(int seed, int x, int y, float &offsetX, float &offsetY) {
+    const std::int32_t vector =
+        hash(seed, prime(x, PRIME_X), prime(y, PRIME_Y)) & VECTOR_INDEX_MASK;
+    offsetX = RAND_VECS_2D[vector] * CELLULAR_JITTER;
+    offsetY = RAND_VECS_2D[vector | 1] * CELLULAR_JITTER;
+}
+
+// Jittered feature point offsets for a rectangle of noise cells, hashed once per octave.
+struct FeatureGrid {
+    int firstX = 0;
+    int firstY = 0;
+    int width = 0;
+    std::vector<float> offsetX;
+    std::vector<float> offsetY;
+
+    void build(int seed, int minX, int maxX, int minY, int maxY) {
+        firstX = minX;
+        firstY = minY;
+        width = maxX - minX + 1;
+        const std::size_t count = static_cast<std::size_t>(width) * (maxY - minY + 1);
+        offsetX.resize(count);
+        offsetY.resize(count);
+        std::size_t index = 0;
+        for (int y = minY; y <= maxY; ++y) {
+            for (int x = minX; x <= maxX; ++x, ++index) {
+                featureOffset(seed, x, y, offsetX[index], offsetY[index]);
+            }
+        }
+    }
+
+    std::size_t indexOf(int x, int y) const {
+        return static_cast<std::size_t>(y - firstY) * width + (x - firstX);
+    }
+};
+
+// One sample, visiting the nine feature points in GetNoise's order.
+float sampleCell(const FeatureGrid &grid, float x, float y, int xr, int yr) {
+    float distance0 = NO_DISTANCE;
+    for (int xi = xr - 1; xi <= xr + 1; ++xi) {
+        for (int yi = yr - 1; yi <= yr + 1; ++yi) {
+            const std::size_t index = grid.indexOf(xi, yi);
+            const float vecX = (static_cast<float>(xi) - x) + grid.offsetX[index];
+            const float vecY = (static_cast<float>(yi) - y) + grid.offsetY[index];
+            distance0 = std::min(distance0, vecX * vecX + vecY * vecY);
+        }
+    }
+    return distance0 - 1.0f;
+}
+
+// One sample, hashing its feature points directly; for lattices too sparse to share them.
+float sampleCellDirect(int seed, float x, float y, int xr, int yr) {
+    float distance0 = NO_DISTANCE;
+    for (int xi = xr - 1; xi <= xr + 1; ++xi) {
+        for (int yi = yr - 1; yi <= yr + 1; ++yi) {
+            float offsetX;
+            float offsetY;
+            featureOffset(seed, xi, yi, offsetX, offsetY);
+            const float vecX = (static_cast<float>(xi) - x) + offsetX;
+            const float vecY = (static_cast<float>(yi) - y) + offsetY;
+            distance0 = std::min(distance0, vecX * vecX + vecY * vecY);
+        }
+    }
+    return distance0 - 1.0f;
+}
+
+// Single-octave cellular noise at the given per-column and per-row noise coordinates.
+void sampleOctave(int seed, const std::vector<float> &xs, const std::vector<float> &ys,
+                  Backend backend, FeatureGrid &grid, float *out) {
+    const int cellsX = static_cast<int>(xs.size());
+    const int cellsY = static_cast<int>(ys.size());
+    std::vector<int> xr(cellsX);
+    std::vector<float> roundedXs(cellsX);
+    for (int x = 0; x < cellsX; ++x) {
+        xr[x] = fastRound(xs[x]);
+        roundedXs[x] = static_cast<float>(xr[x]);
+    }
+    std::vector<int> yr(cellsY);
+    for (int y = 0; y < cellsY; ++y) {
+        yr[y] = fastRound(ys[y]);
+    }
+
+    // Noise cells between neighbouring samples. A shared grid only pays off while samples
+    // outnumber the cells it hashes, and lanes only while they share candidate columns.
+    const float spacing = std::max(cellsX > 1 ? std::abs(xs[1] - xs[0]) : 0.0f,
+                                   cellsY > 1 ? std::abs(ys[1] - ys[0]) : 0.0f);
+    if (spacing >= MAX_GRID_SPACING) {
+        for (int y = 0; y < cellsY; ++y) {
+            float *row = out + static_cast<std::size_t>(y) * cellsX;
+            for (int x = 0; x < cellsX; ++x) {
+                row[x] = sampleCellDirect(seed, xs[x], ys[y], xr[x], yr[y]);
+            }
+        }
+        return;
+    }
+
+    const auto [minX, maxX] = std::minmax_element(xr.begin(), xr.end());
+    const auto [minY, maxY] = std::minmax_element(yr.begin(), yr.end());
+    grid.build(seed, *minX - 1, *maxX + 1, *minY - 1, *maxY + 1);
+
+    if (backend == Backend::Wide && spacing <= MAX_LANE_SPACING) {
+        const SimdKernels::Table &kernels = SimdKernels::active();
+        SimdKernels::CellularRow row;
+        row.offsetX = grid.offsetX.data();
+        row.offsetY = grid.offsetY.data();
+        row.gridFirstX = grid.firstX;
+        row.gridFirstY = grid.firstY;
+        row.gridWidth = grid.width;
+        row.xs = xs.data();
+        row.xr = xr.data();
+        row.roundedXs = roundedXs.data();
+        for (int y = 0; y < cellsY; ++y) {
+            row.y = ys[y];
+            row.yr = yr[y];
+            row.out = out + static_cast<std::size_t>(y) * cellsX;
+            kernels.sampleCellularRow(row, 0, cellsX);
+        }
+        return;
+    }
+
+    for (int y = 0; y < cellsY; ++y) {
+        float *row = out + static_cast<std::size_t>(y) * cellsX;
+        for (int x = 0; x < cellsX; ++x) {
+            row[x] = sampleCell(grid, xs[x], ys[y], xr[x], yr[y]);
+        }
+    }
+}
+
+}  // namespace
+
+bool supports(const NoiseLayer &layer) {
+    return layer.noiseType == FastNoiseLite::NoiseType_Cellular
+           && (layer.fractalType == FastNoiseLite::FractalType_None
+               || (layer.fractalType == FastNoiseLite::FractalType_FBm && layer.octaves > 0));
+}
+
+void sampleField(const NoiseLayer &layer, const TerrainKernel::ChunkLattice &lattice, float *out,
+                 Backend backend) {
+    if (lattice.cellCount() <= 0) {
+        return;
+    }
+    std::vector<float> xs;
+    std::vector<float> ys;
+    TerrainKernel::noiseCoordinates(lattice, layer.frequency, xs, ys);
+
+    FeatureGrid grid;
+    if (layer.fractalType == FastNoiseLite::FractalType_None) {
+        sampleOctave(layer.seed, xs, ys, backend, grid, out);
+        return;
+    }
+
+    const std::size_t cellCount = static_cast<std::size_t>(lattice.cellCount());
+    std::fill(out, out + cellCount, 0.0f);
+    std::vector<float> octave(cellCount);
+    float amp = fractalBounding(layer.octaves, layer.gain);
+    for (int i = 0; i < layer.octaves; ++i) {
+        sampleOctave(layer.seed + i, xs, ys, backend, grid, octave.data());
+        for (std::size_t cell = 0; cell < cellCount; ++cell) {
+            out[cell] += octave[cell] * amp;
+        }
+        for (float &x : xs) {
+            x *= layer.lacunarity;
+        }
+        for (float &y : ys) {
+            y *= layer.lacunarity;
+        }
+        amp *= layer.gain;
+    }
+}
+
+BenchmarkResult benchmark(const FastNoiseLite &noise, const NoiseLayer &layer, int cells,
+                          int repetitions) {
+    BenchmarkResult result;
+    const TerrainKernel::ChunkLattice lattice = NoiseBenchmark::squareLattice(cells);
+    result.samples = lattice.cellCount();
+
+    const std::size_t cellCount = static_cast<std::size_t>(lattice.cellCount());
+    std::vector<float> reference(cellCount);
+    std::vector<float> scalar(cellCount);
+    std::vector<float> wide(cellCount);
+    for (int i = 0; i < repetitions; ++i) {
+        result.perSampleMs += NoiseBenchmark::millisecondsFor(
+            [&]() { TerrainKernel::sampleNoiseField(noise, lattice, reference.data()); });
+        result.scalarMs += NoiseBenchmark::millisecondsFor(
+            [&]() { sampleField(layer, lattice, scalar.data(), Backend::Scalar); });
+        result.wideMs += NoiseBenchmark::millisecondsFor(
+            [&]() { sampleField(layer, lattice, wide.data(), Backend::Wide); });
+    }
+    result.maxDifference = std::max(NoiseBenchmark::maxDifference(scalar, reference),
+                                    NoiseBenchmark::maxDifference(wide, reference));
+    return result;
+}
+
+}  // namespace CellularNoise
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "FastNoiseLite.h"
+#include "world/TerrainKernel.h"
+
+struct NoiseLayer;
+
+// Whole-lattice evaluation of FastNoiseLite's 2D cellular noise. Per-sample GetNoise hashes
+// and looks up the same nine feature points for every cell of a chunk; here the feature
+// points of each noise cell are resolved once per octave and shared by every sample that
+// can reach them, and a row's distances are computed over SIMD lanes. Results match GetNoise
+// for the layers supports() accepts.
+namespace CellularNoise {
+
+enum class Backend {
+    Scalar,
+    Wide,
+};
+
+// True for cellular layers with no fractal or FBm. The remaining cellular settings are
+// FastNoiseLite's defaults, which NoiseLayer does not expose.
+bool supports(const NoiseLayer &layer);
+
+// Writes the raw output of a noise generator configured from `layer` for every lattice cell
+// into `out`, as TerrainKernel::sampleNoiseField would. `layer` must be supported.
+void sampleField(const NoiseLayer &layer, const TerrainKernel::ChunkLattice &lattice, float *out,
+                 Backend backend = Backend::Wide);
+
+struct BenchmarkResult {
+    int samples = 0;
+    double perSampleMs = 0.0;
+    double scalarMs = 0.0;
+    double wideMs = 0.0;
+    // Largest difference from the per-sample path over either backend.
+    float maxDifference = 0.0f;
+};
+
+// Times `repetitions` passes of the per-sample path, built on `noise`, against both backends
+// over a `cells` x `cells` lattice.
+BenchmarkResult benchmark(const FastNoiseLite &noise, const NoiseLayer &layer, int cells,
+                          int repetitions);
+
+}  // namespace CellularNoise
@@ -0,0 +1,333 @@
+#include "ChunkDiskCache.h"
+#include "Logger.h"
+#include "core/Hash.h"
+#include "systems/world/WorldGenerationSystem.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define TRANSITY_CHUNK_CACHE_PREAD 1
+#endif
+
+namespace {
+
+constexpr std::uint32_t CHUNK_FILE_MAGIC = 0x4B484354;  // "TCHK"
+// Bump whenever generateChunkData starts producing different output for the same params.
+constexpr std::uint32_t CHUNK_FILE_VERSION = 3;
+
+struct ChunkFileHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::int32_t chunkX;
+    std::int32_t chunkY;
+    std::int32_t lodLevel;
+    std::uint32_t cellCount;
+    // Scale the quantized elevations were packed against.
+    float maxElevation;
+};
+
+// The cache is trimmed each time this fraction of its budget has been written.
+constexpr std::uint64_t TRIM_INTERVAL_DIVISOR = 16;
+
+// Header, then the packed terrain bytes, then one 16-bit elevation per cell.
+std::size_t payloadSize(std::size_t cellCount) {
+    return sizeof(ChunkFileHeader) + PackedTerrainCells::byteCountFor(cellCount)
+           + cellCount * sizeof(std::uint16_t);
+}
+
+bool readWholeFile(const std::filesystem::path &path, std::vector<char> &buffer) {
+#ifdef TRANSITY_CHUNK_CACHE_PREAD
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    const ssize_t bytesRead = ::pread(fd, buffer.data(), buffer.size(), 0);
+    ::close(fd);
+    return bytesRead == static_cast<ssize_t>(buffer.size());
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return file.gcount() == static_cast<std::streamsize>(buffer.size());
+#endif
+}
+
+}  // namespace
+
+ChunkDiskCache::ChunkDiskCache(std::filesystem::path rootDirectory, std::uint64_t budgetBytes)
+    : _rootDirectory(std::move(rootDirectory)), _budgetBytes(budgetBytes),
+      _bytesSinceTrim(budgetBytes / TRIM_INTERVAL_DIVISOR) {
+    std::error_code ec;
+    std::filesystem::create_directories(_rootDirectory, ec);
+    _enabled = !ec;
+    if (_enabled) {
+        LOG_INFO("ChunkDiskCache", "Chunk cache directory: %s", _rootDirectory.string().c_str());
+    } else {
+        LOG_WARN("ChunkDiskCache", "Chunk cache disabled, cannot create %s: %s",
+                 _rootDirectory.string().c_str(), ec.message().c_str());
+    }
+}
+
+std::filesystem::path ChunkDiskCache::userCacheDirectory() {
+    auto fromEnvironment = [](const char *name) {
+        const char *value = std::getenv(name);
+        std::filesystem::path directory = value ? value : "";
+        // Relative values are ignored, as the XDG spec requires.
+        return directory.is_absolute() ? directory : std::filesystem::path();
+    };
+
+#ifdef _WIN32
+    std::filesystem::path directory = fromEnvironment("LOCALAPPDATA");
+#elif defined(__APPLE__)
+    std::filesystem::path directory = fromEnvironment("HOME");
+    if (!directory.empty()) {
+        directory /= "Library/Caches";
+    }
+#else
+    std::filesystem::path directory = fromEnvironment("XDG_CACHE_HOME");
+    if (directory.empty()) {
+        directory = fromEnvironment("HOME");
+        if (!directory.empty()) {
+            directory /= ".cache";
+        }
+    }
+#endif
+
+    if (directory.empty()) {
+        std::error_code ec;
+        directory = std::filesystem::current_path(ec);
+    }
+    return directory;
+}
+
+std::uint64_t ChunkDiskCache::fingerprint(const WorldGenSnapshot &snapshot) {
+    const WorldGenParams &params = snapshot.params;
+    Fnv1a hash;
+    hash.add(CHUNK_FILE_VERSION);
+    hash.add(snapshot.noiseBackend);
+    hash.add(params.noiseLayers.size());
+    for (std::size_t i = 0; i < params.noiseLayers.size(); ++i) {
+        // Each signature covers the layer's generator settings, and the octave split
+        // settings only where the split applies to that layer.
+        hash.add(snapshot.layerSignatures[i]);
+        hash.add(params.noiseLayers[i].weight);
+    }
+    hash.add(params.landThreshold);
+    hash.add(params.coastlineDistortionStrength);
+    hash.add(params.elevation.maxElevation);
+    hash.add(params.elevation.elevationExponent);
+    hash.add(params.worldDimensionsInChunks.x);
+    hash.add(params.worldDimensionsInChunks.y);
+    hash.add(params.chunkDimensionsInCells.x);
+    hash.add(params.chunkDimensionsInCells.y);
+    hash.add(params.cellSize);
+    return hash.value();
+}
+
+std::filesystem::path ChunkDiskCache::fingerprintDirectory(std::uint64_t paramsFingerprint) const {
+    char directory[17];
+    std::snprintf(directory, sizeof(directory), "%016llx",
+                  static_cast<unsigned long long>(paramsFingerprint));
+    return _rootDirectory / directory;
+}
+
+std::filesystem::path ChunkDiskCache::chunkPath(std::uint64_t paramsFingerprint,
+                                                const sf::Vector2i &chunkGridPosition,
+                                                int lodLevel) const {
+    char fileName[48];
+    std::snprintf(fileName, sizeof(fileName), "%d_%d_%d.chunk", lodLevel, chunkGridPosition.x,
+                  chunkGridPosition.y);
+    return fingerprintDirectory(paramsFingerprint) / fileName;
+}
+
+void ChunkDiskCache::markUsed(std::uint64_t paramsFingerprint) const {
+    if (_lastUsedFingerprint.exchange(paramsFingerprint, std::memory_order_relaxed)
+        == paramsFingerprint) {
+        return;
+    }
+    std::error_code ec;
+    std::filesystem::last_write_time(fingerprintDirectory(paramsFingerprint),
+                                     std::filesystem::file_time_type::clock::now(), ec);
+}
+
+void ChunkDiskCache::trim(std::uint64_t keepFingerprint) const {
+    // One trim at a time is enough; a thread that finds one running skips its own.
+    std::unique_lock<std::mutex> lock(_trimMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+
+    struct FingerprintDirectory {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUsed;
+        std::uint64_t bytes = 0;
+    };
+
+    const auto keep = fingerprintDirectory(keepFingerprint);
+    const auto lastUsed =
+        fingerprintDirectory(_lastUsedFingerprint.load(std::memory_order_relaxed));
+    std::vector<FingerprintDirectory> candidates;
+    std::uint64_t totalBytes = 0;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(_rootDirectory, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        std::error_code entryError;
+        if (!it->is_directory(entryError)) {
+            continue;
+        }
+        FingerprintDirectory directory{it->path(), it->last_write_time(entryError)};
+        for (std::filesystem::directory_iterator file(it->path(), entryError);
+             !entryError && file != end; file.increment(entryError)) {
+            std::error_code sizeError;
+            const auto size = file->file_size(sizeError);
+            if (!sizeError) {
+                directory.bytes += size;
+            }
+        }
+        totalBytes += directory.bytes;
+        if (directory.path != keep && directory.path != lastUsed) {
+            candidates.push_back(std::move(directory));
+        }
+    }
+    if (totalBytes <= _budgetBytes) {
+        return;
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const FingerprintDirectory &a, const FingerprintDirectory &b) {
+                  return a.lastUsed < b.lastUsed;
+              });
+    std::size_t removed = 0;
+    std::uint64_t freedBytes = 0;
+    for (const auto &directory : candidates) {
+        if (totalBytes <= _budgetBytes) {
+            break;
+        }
+        std::filesystem::remove_all(directory.path, ec);
+        if (ec) {
+            LOG_WARN("ChunkDiskCache", "Cannot evict %s: %s", directory.path.string().c_str(),
+                     ec.message().c_str());
+            continue;
+        }
+        totalBytes -= directory.bytes;
+        freedBytes += directory.bytes;
+        ++removed;
+    }
+    LOG_INFO("ChunkDiskCache", "Evicted %zu cached worlds (%llu KiB); %llu KiB remain.", removed,
+             static_cast<unsigned long long>(freedBytes / 1024),
+             static_cast<unsigned long long>(totalBytes / 1024));
+}
+
+std::optional<GeneratedChunkData>
+ChunkDiskCache::load(std::uint64_t paramsFingerprint, const sf::Vector2i &chunkGridPosition,
+                     int lodLevel, std::size_t expectedCellCount) const {
+    if (!_enabled) {
+        return std::nullopt;
+    }
+
+    std::vector<char> buffer(payloadSize(expectedCellCount));
+    if (!readWholeFile(chunkPath(paramsFingerprint, chunkGridPosition, lodLevel), buffer)) {
+        return std::nullopt;
+    }
+
+    ChunkFileHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (header.magic != CHUNK_FILE_MAGIC || header.version != CHUNK_FILE_VERSION
+        || header.chunkX != chunkGridPosition.x || header.chunkY != chunkGridPosition.y
+        || header.lodLevel != lodLevel || header.cellCount != expectedCellCount) {
+        LOG_WARN("ChunkDiskCache", "Ignoring mismatched cache file for chunk (%d, %d).",
+                 chunkGridPosition.x, chunkGridPosition.y);
+        return std::nullopt;
+    }
+
+    markUsed(paramsFingerprint);
+
+    GeneratedChunkData chunkData;
+    chunkData.chunkGridPosition = chunkGridPosition;
+    chunkData.lodLevel = lodLevel;
+
+    const char *cursor = buffer.data() + sizeof(header);
+    const std::size_t terrainBytes = PackedTerrainCells::byteCountFor(expectedCellCount);
+    std::vector<std::uint8_t> cells(terrainBytes);
+    std::memcpy(cells.data(), cursor, terrainBytes);
+    cursor += terrainBytes;
+    std::vector<std::uint16_t> elevations(expectedCellCount);
+    std::memcpy(elevations.data(), cursor, expectedCellCount * sizeof(std::uint16_t));
+
+    chunkData.cells.assignBytes(std::move(cells), expectedCellCount);
+    chunkData.elevations.assignValues(std::move(elevations), expectedCellCount,
+                                      header.maxElevation);
+    return chunkData;
+}
+
+bool ChunkDiskCache::store(std::uint64_t paramsFingerprint,
+                           const GeneratedChunkData &chunkData) const {
+    if (!_enabled || chunkData.cells.size() != chunkData.elevations.size()) {
+        return false;
+    }
+
+    const auto path =
+        chunkPath(paramsFingerprint, chunkData.chunkGridPosition, chunkData.lodLevel);
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec) {
+        LOG_WARN("ChunkDiskCache", "Cannot create %s: %s", path.parent_path().string().c_str(),
+                 ec.message().c_str());
+        return false;
+    }
+
+    const std::size_t cellCount = chunkData.cells.size();
+    std::vector<char> buffer(payloadSize(cellCount));
+    const ChunkFileHeader header{CHUNK_FILE_MAGIC,
+                                 CHUNK_FILE_VERSION,
+                                 chunkData.chunkGridPosition.x,
+                                 chunkData.chunkGridPosition.y,
+                                 chunkData.lodLevel,
+                                 static_cast<std::uint32_t>(cellCount),
+                                 chunkData.elevations.getMaxElevation()};
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    char *cursor = buffer.data() + sizeof(header);
+    chunkData.cells.copyBytes(reinterpret_cast<std::uint8_t *>(cursor));
+    cursor += PackedTerrainCells::byteCountFor(cellCount);
+    // The buffer has no alignment guarantee for 16-bit stores, so stage the values first.
+    std::vector<std::uint16_t> elevations(cellCount);
+    chunkData.elevations.copyValues(elevations.data());
+    std::memcpy(cursor, elevations.data(), cellCount * sizeof(std::uint16_t));
+
+    // Two I/O threads may write the same chunk; give each its own temporary file.
+    auto tempPath = path;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+            LOG_WARN("ChunkDiskCache", "Failed to write %s", tempPath.string().c_str());
+            file.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    const std::uint64_t trimInterval = _budgetBytes / TRIM_INTERVAL_DIVISOR;
+    if (_bytesSinceTrim.fetch_add(buffer.size(), std::memory_order_relaxed) + buffer.size()
+        >= trimInterval) {
+        _bytesSinceTrim.store(0, std::memory_order_relaxed);
+        trim(paramsFingerprint);
+    }
+    return true;
+}
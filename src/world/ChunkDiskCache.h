@@ -0,0 +1,62 @@
+#pragma once
+
+#include "world/WorldData.h"
+#include <SFML/System/Vector2.hpp>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+
+struct WorldGenSnapshot;
+
+// Content-addressed store for generated chunks. Files live under
+// <root>/<params fingerprint>/<lod>_<x>_<y>.chunk, so a chunk is only ever served for the exact
+// generation parameters that produced it and stale worlds never need invalidating. Once the
+// cache outgrows its byte budget, the least recently used fingerprint directories are deleted.
+// All methods are safe to call concurrently from I/O threads.
+class ChunkDiskCache {
+public:
+    ChunkDiskCache(std::filesystem::path rootDirectory, std::uint64_t budgetBytes);
+
+    // The platform's per-user cache directory, so the cache is found again whatever the
+    // working directory: %LOCALAPPDATA%, ~/Library/Caches, or $XDG_CACHE_HOME (~/.cache).
+    // Falls back to the working directory when none of these is set.
+    static std::filesystem::path userCacheDirectory();
+
+    // Hash of everything in the snapshot that affects generated terrain, the noise backend
+    // included, so switching backends never serves one backend's chunks to the other.
+    static std::uint64_t fingerprint(const WorldGenSnapshot &snapshot);
+
+    // Reads a cached chunk with a single pread. Returns nothing on a miss or when the
+    // file is truncated, corrupt or was written for a different chunk size.
+    std::optional<GeneratedChunkData> load(std::uint64_t paramsFingerprint,
+                                           const sf::Vector2i &chunkGridPosition,
+                                           int lodLevel, std::size_t expectedCellCount) const;
+
+    // Writes the chunk to a temporary file and renames it into place, so readers never
+    // observe a partial file.
+    bool store(std::uint64_t paramsFingerprint, const GeneratedChunkData &chunkData) const;
+
+    bool isEnabled() const noexcept { return _enabled; }
+
+private:
+    std::filesystem::path fingerprintDirectory(std::uint64_t paramsFingerprint) const;
+    std::filesystem::path chunkPath(std::uint64_t paramsFingerprint,
+                                    const sf::Vector2i &chunkGridPosition, int lodLevel) const;
+    // Bumps the directory's mtime the first time a fingerprint is read from in a row, so
+    // eviction sees it as recently used even when nothing new is written to it.
+    void markUsed(std::uint64_t paramsFingerprint) const;
+    // Deletes the oldest fingerprint directories until the cache fits its budget. Never
+    // deletes `keepFingerprint` or the one last read from.
+    void trim(std::uint64_t keepFingerprint) const;
+
+    std::filesystem::path _rootDirectory;
+    std::uint64_t _budgetBytes = 0;
+    bool _enabled = false;
+    mutable std::atomic<std::uint64_t> _lastUsedFingerprint{0};
+    // Bytes written since the last trim. Starts at the trim interval so the first write of a
+    // session also trims what earlier sessions left behind.
+    mutable std::atomic<std::uint64_t> _bytesSinceTrim;
+    mutable std::mutex _trimMutex;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "world/ChunkKey.h"
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Inclusive range of chunk positions on one level of the LOD pyramid.
+struct ChunkRect {
+    int lodLevel = 0;
+    sf::Vector2i min = {0, 0};
+    sf::Vector2i max = {-1, -1};
+
+    bool empty() const { return max.x < min.x || max.y < min.y; }
+
+    bool contains(const ChunkKey &key) const {
+        return key.lodLevel == lodLevel && key.position.x >= min.x && key.position.x <= max.x
+               && key.position.y >= min.y && key.position.y <= max.y;
+    }
+
+    bool operator==(const ChunkRect &other) const {
+        return (empty() && other.empty())
+               || (lodLevel == other.lodLevel && min == other.min && max == other.max);
+    }
+    bool operator!=(const ChunkRect &other) const { return !(*this == other); }
+
+    template <typename F> void forEach(F &&visit) const {
+        forEachIn(min, max, visit);
+    }
+
+    // Visits the keys of this rect that are not in `excluded`. Only the strips outside the
+    // overlap are walked, so a one-chunk pan costs one row or column.
+    template <typename F> void forEachOutside(const ChunkRect &excluded, F &&visit) const {
+        if (empty()) {
+            return;
+        }
+        const sf::Vector2i lo = {std::max(min.x, excluded.min.x),
+                                 std::max(min.y, excluded.min.y)};
+        const sf::Vector2i hi = {std::min(max.x, excluded.max.x),
+                                 std::min(max.y, excluded.max.y)};
+        if (excluded.empty() || excluded.lodLevel != lodLevel || lo.x > hi.x || lo.y > hi.y) {
+            forEach(visit);
+            return;
+        }
+        forEachIn(min, {max.x, lo.y - 1}, visit);
+        forEachIn({min.x, hi.y + 1}, max, visit);
+        forEachIn({min.x, lo.y}, {lo.x - 1, hi.y}, visit);
+        forEachIn({hi.x + 1, lo.y}, {max.x, hi.y}, visit);
+    }
+
+private:
+    template <typename F>
+    void forEachIn(const sf::Vector2i &from, const sf::Vector2i &to, F &visit) const {
+        for (int y = from.y; y <= to.y; ++y) {
+            for (int x = from.x; x <= to.x; ++x) {
+                visit(ChunkKey{{x, y}, lodLevel});
+            }
+        }
+    }
+};
+
+// Dense storage for one value per chunk on every level of the LOD pyramid. The world is
+// bounded, so a lookup is a bounds check and an index computation rather than a tree walk.
+template <typename T> class ChunkGrid {
+public:
+    void reset(const sf::Vector2i &worldDimensionsInChunks, int maxLodLevel) {
+        _levels.clear();
+        std::size_t offset = 0;
+        for (int level = 0; level <= maxLodLevel; ++level) {
+            const int step = 1 << level;
+            const sf::Vector2i dims = {
+                std::max(0, (worldDimensionsInChunks.x + step - 1) / step),
+                std::max(0, (worldDimensionsInChunks.y + step - 1) / step)};
+            _levels.push_back({dims, offset});
+            offset += static_cast<std::size_t>(dims.x) * dims.y;
+        }
+        _cells.assign(offset, T{});
+    }
+
+    bool contains(const ChunkKey &key) const {
+        if (key.lodLevel < 0 || key.lodLevel >= static_cast<int>(_levels.size())) {
+            return false;
+        }
+        const sf::Vector2i &dims = _levels[key.lodLevel].dims;
+        return key.position.x >= 0 && key.position.x < dims.x && key.position.y >= 0
+               && key.position.y < dims.y;
+    }
+
+    // The key must be contained in the grid.
+    T &operator[](const ChunkKey &key) { return _cells[indexOf(key)]; }
+    const T &operator[](const ChunkKey &key) const { return _cells[indexOf(key)]; }
+
+    // Clamps the rect to the chunks that exist on its level.
+    ChunkRect clip(ChunkRect rect) const {
+        if (rect.lodLevel < 0 || rect.lodLevel >= static_cast<int>(_levels.size())) {
+            return ChunkRect{};
+        }
+        const sf::Vector2i &dims = _levels[rect.lodLevel].dims;
+        rect.min = {std::max(rect.min.x, 0), std::max(rect.min.y, 0)};
+        rect.max = {std::min(rect.max.x, dims.x - 1), std::min(rect.max.y, dims.y - 1)};
+        return rect;
+    }
+
+private:
+    struct Level {
+        sf::Vector2i dims;
+        std::size_t offset;
+    };
+
+    std::size_t indexOf(const ChunkKey &key) const {
+        const Level &level = _levels[key.lodLevel];
+        return level.offset + static_cast<std::size_t>(key.position.y) * level.dims.x
+               + key.position.x;
+    }
+
+    std::vector<Level> _levels;
+    std::vector<T> _cells;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+struct Vector2iCompare {
+    bool operator()(const sf::Vector2i &a, const sf::Vector2i &b) const {
+        if (a.x != b.x) return a.x < b.x;
+        return a.y < b.y;
+    }
+};
+
+// Identifies a chunk within one level of the LOD pyramid.
+struct ChunkKey {
+    sf::Vector2i position;
+    int lodLevel = 0;
+};
+
+struct ChunkKeyCompare {
+    bool operator()(const ChunkKey &a, const ChunkKey &b) const {
+        if (a.lodLevel != b.lodLevel) return a.lodLevel < b.lodLevel;
+        return Vector2iCompare{}(a.position, b.position);
+    }
+};
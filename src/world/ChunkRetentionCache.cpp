@@ -0,0 +1,82 @@
+#include "ChunkRetentionCache.h"
+#include <SFML/Graphics/Vertex.hpp>
+
+ChunkRetentionCache::ChunkRetentionCache(std::size_t budgetBytes) : _budgetBytes(budgetBytes) {}
+
+std::vector<ChunkKey> ChunkRetentionCache::insert(const ChunkKey &key, RetainedChunk chunk) {
+    auto existing = _index.find(key);
+    if (existing != _index.end()) {
+        _bytes -= existing->second->bytes;
+        _entries.erase(existing->second);
+        _index.erase(existing);
+    }
+
+    const std::size_t bytes = byteSize(chunk);
+    _entries.push_front(Entry{key, std::move(chunk), bytes});
+    _index[key] = _entries.begin();
+    _bytes += bytes;
+
+    std::vector<ChunkKey> evicted;
+    evictToBudget(evicted);
+    return evicted;
+}
+
+std::optional<RetainedChunk> ChunkRetentionCache::take(const ChunkKey &key) {
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        return std::nullopt;
+    }
+
+    RetainedChunk chunk = std::move(it->second->chunk);
+    _bytes -= it->second->bytes;
+    _entries.erase(it->second);
+    _index.erase(it);
+    ++_stats.hits;
+    return chunk;
+}
+
+void ChunkRetentionCache::invalidateMeshes() {
+    for (auto &entry : _entries) {
+        entry.chunk.isMeshDirty = true;
+    }
+}
+
+void ChunkRetentionCache::clear() {
+    _entries.clear();
+    _index.clear();
+    _bytes = 0;
+}
+
+ChunkRetentionStats ChunkRetentionCache::getStats() const {
+    ChunkRetentionStats stats = _stats;
+    stats.retainedChunks = _entries.size();
+    stats.retainedBytes = _bytes;
+    return stats;
+}
+
+std::size_t ChunkRetentionCache::byteSize(const RetainedChunk &chunk) {
+    std::size_t bytes = sizeof(Entry);
+    bytes += chunk.cells.byteSize();
+    bytes += chunk.elevations.byteSize();
+    bytes += chunk.mesh.getVertexCount() * sizeof(sf::Vertex);
+    if (chunk.noiseFields) {
+        for (const auto &layer : chunk.noiseFields->layers) {
+            bytes += layer ? layer->values.size() * sizeof(float) : 0;
+        }
+        if (chunk.noiseFields->distortion) {
+            bytes += chunk.noiseFields->distortion->values.size() * sizeof(float);
+        }
+    }
+    return bytes;
+}
+
+void ChunkRetentionCache::evictToBudget(std::vector<ChunkKey> &evicted) {
+    while (_bytes > _budgetBytes && !_entries.empty()) {
+        const Entry &oldest = _entries.back();
+        evicted.push_back(oldest.key);
+        _bytes -= oldest.bytes;
+        _index.erase(oldest.key);
+        _entries.pop_back();
+        ++_stats.evictions;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "world/ChunkKey.h"
+#include "world/WorldData.h"
+#include <SFML/Graphics/VertexArray.hpp>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Everything needed to bring an unloaded chunk back without regenerating it, including
+// the mesh that was built for it.
+struct RetainedChunk {
+    PackedTerrainCells cells;
+    QuantizedElevations elevations;
+    std::shared_ptr<const ChunkNoiseFields> noiseFields;
+    sf::VertexArray mesh;
+    bool isMeshDirty = true;
+};
+
+struct ChunkRetentionStats {
+    std::size_t retainedChunks = 0;
+    std::size_t retainedBytes = 0;
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+};
+
+// Holds recently unloaded chunks in least-recently-used order, evicting the oldest once
+// their combined size exceeds the byte budget. Used from the main thread only.
+class ChunkRetentionCache {
+public:
+    explicit ChunkRetentionCache(std::size_t budgetBytes);
+
+    // Returns the keys evicted to stay within the budget.
+    std::vector<ChunkKey> insert(const ChunkKey &key, RetainedChunk chunk);
+
+    // Removes and returns the chunk if it is retained, counting a hit.
+    std::optional<RetainedChunk> take(const ChunkKey &key);
+
+    // Counts a request that had to go to the disk cache or generator instead.
+    void recordMiss() { ++_stats.misses; }
+
+    // Forces every retained mesh to be rebuilt on restore, e.g. after a theme change.
+    void invalidateMeshes();
+
+    void clear();
+
+    ChunkRetentionStats getStats() const;
+
+private:
+    struct Entry {
+        ChunkKey key;
+        RetainedChunk chunk;
+        std::size_t bytes;
+    };
+
+    static std::size_t byteSize(const RetainedChunk &chunk);
+    void evictToBudget(std::vector<ChunkKey> &evicted);
+
+    // Most recently inserted first.
+    std::list<Entry> _entries;
+    std::map<ChunkKey, std::list<Entry>::iterator, ChunkKeyCompare> _index;
+    std::size_t _budgetBytes;
+    std::size_t _bytes = 0;
+    ChunkRetentionStats _stats;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "world/TerrainKernel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Shared scaffolding for the noise sampler benchmarks shown in the debug overlay.
+namespace NoiseBenchmark {
+
+// A `cells` x `cells` lattice at the world origin, at least one cell across.
+inline TerrainKernel::ChunkLattice squareLattice(int cells) {
+    TerrainKernel::ChunkLattice lattice;
+    lattice.cellsX = std::max(1, cells);
+    lattice.cellsY = lattice.cellsX;
+    return lattice;
+}
+
+// Wall time of one call to `run`, in milliseconds.
+template <typename Run>
+double millisecondsFor(Run &&run) {
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// Largest absolute difference between two fields of the same size.
+inline float maxDifference(const std::vector<float> &values, const std::vector<float> &reference) {
+    float difference = 0.0f;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        difference = std::max(difference, std::abs(values[i] - reference[i]));
+    }
+    return difference;
+}
+
+}  // namespace NoiseBenchmark
@@ -0,0 +1,406 @@
+#include "NoisePipeline.h"
+#include "world/CellularNoise.h"
+#include "world/FastNoiseInternals.h"
+#include "world/NoiseBenchmark.h"
+#include "world/WorldData.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace NoisePipeline {
+
+namespace {
+
+using namespace FastNoiseInternals;
+
+constexpr float PERLIN_SCALE = 1.4247691104677813f;
+constexpr std::int32_t GRADIENT_INDEX_MASK = 127 << 1;
+// Cost of upsampling one cell, relative to evaluating one octave there.
+constexpr float UPSAMPLE_COST = 0.25f;
+
+struct PerlinNoise {
+    static float gradient(int seed, std::int32_t xPrimed, std::int32_t yPrimed, float xd,
+                          float yd) {
+        std::int32_t value = hash(seed, xPrimed, yPrimed);
+        value ^= value >> 15;
+        value &= GRADIENT_INDEX_MASK;
+        return xd * GRADIENTS_2D[value] + yd * GRADIENTS_2D[value | 1];
+    }
+
+    static float sample(int seed, float x, float y) {
+        const int x0 = fastFloor(x);
+        const int y0 = fastFloor(y);
+        const float xd0 = x - static_cast<float>(x0);
+        const float yd0 = y - static_cast<float>(y0);
+        const float xd1 = xd0 - 1;
+        const float yd1 = yd0 - 1;
+        const float xs = interpQuintic(xd0);
+        const float ys = interpQuintic(yd0);
+
+        const std::int32_t xPrimed0 = prime(x0, PRIME_X);
+        const std::int32_t yPrimed0 = prime(y0, PRIME_Y);
+        const std::int32_t xPrimed1 = prime(x0 + 1, PRIME_X);
+        const std::int32_t yPrimed1 = prime(y0 + 1, PRIME_Y);
+        const float xf0 = lerp(gradient(seed, xPrimed0, yPrimed0, xd0, yd0),
+                               gradient(seed, xPrimed1, yPrimed0, xd1, yd0), xs);
+        const float xf1 = lerp(gradient(seed, xPrimed0, yPrimed1, xd0, yd1),
+                               gradient(seed, xPrimed1, yPrimed1, xd1, yd1), xs);
+        return lerp(xf0, xf1, ys) * PERLIN_SCALE;
+    }
+
+    // Largest difference Catmull-Rom upsampling from a lattice `step` noise units apart
+    // makes to a unit-amplitude octave; fitted above measured maxima. Quintic interpolation
+    // keeps Perlin noise smooth enough for third-order convergence.
+    static float upsampleError(float step) { return 6.0f * step * step * step; }
+};
+
+struct ValueNoise {
+    static float value(int seed, std::int32_t xPrimed, std::int32_t yPrimed) {
+        std::uint32_t bits = static_cast<std::uint32_t>(hash(seed, xPrimed, yPrimed));
+        bits *= bits;
+        bits ^= bits << 19;
+        return static_cast<float>(static_cast<std::int32_t>(bits)) * (1 / 2147483648.0f);
+    }
+
+    static float sample(int seed, float x, float y) {
+        const int x0 = fastFloor(x);
+        const int y0 = fastFloor(y);
+        const float xs = interpHermite(x - static_cast<float>(x0));
+        const float ys = interpHermite(y - static_cast<float>(y0));
+
+        const std::int32_t xPrimed0 = prime(x0, PRIME_X);
+        const std::int32_t yPrimed0 = prime(y0, PRIME_Y);
+        const std::int32_t xPrimed1 = prime(x0 + 1, PRIME_X);
+        const std::int32_t yPrimed1 = prime(y0 + 1, PRIME_Y);
+        const float xf0 =
+            lerp(value(seed, xPrimed0, yPrimed0), value(seed, xPrimed1, yPrimed0), xs);
+        const float xf1 =
+            lerp(value(seed, xPrimed0, yPrimed1), value(seed, xPrimed1, yPrimed1), xs);
+        return lerp(xf0, xf1, ys);
+    }
+
+    // Hermite interpolation leaves value noise with only second-order convergence.
+    static float upsampleError(float step) { return step * step; }
+};
+
+struct Fractal {
+    int seed = 0;
+    float lacunarity = 2.0f;
+    float gain = 0.5f;
+    float bounding = 1.0f;
+    // Octaves [firstOctave, endOctave) are summed; the rest still advance the coordinates,
+    // so a range evaluates to exactly its terms of the full sum.
+    int firstOctave = 0;
+    int endOctave = 1;
+};
+
+// The fractal policies leave out FastNoiseLite's weighted-strength factor, which is
+// exactly 1 at the default strength of zero that NoiseLayer always uses. A single-octave
+// policy is only ever asked for its one octave.
+struct NoFractal {
+    static constexpr bool SPLITTABLE = true;
+
+    template <typename Noise>
+    static float sample(const Fractal &fractal, float x, float y) {
+        return Noise::sample(fractal.seed, x, y);
+    }
+};
+
+struct FBmFractal {
+    static constexpr bool SPLITTABLE = true;
+
+    template <typename Noise>
+    static float sample(const Fractal &fractal, float x, float y) {
+        int seed = fractal.seed;
+        float sum = 0;
+        float amp = fractal.bounding;
+        for (int i = 0; i < fractal.endOctave; ++i, ++seed) {
+            if (i >= fractal.firstOctave) {
+                sum += Noise::sample(seed, x, y) * amp;
+            }
+            x *= fractal.lacunarity;
+            y *= fractal.lacunarity;
+            amp *= fractal.gain;
+        }
+        return sum;
+    }
+};
+
+struct RidgedFractal {
+    static constexpr bool SPLITTABLE = false;
+
+    template <typename Noise>
+    static float sample(const Fractal &fractal, float x, float y) {
+        int seed = fractal.seed;
+        float sum = 0;
+        float amp = fractal.bounding;
+        for (int i = 0; i < fractal.endOctave; ++i) {
+            const float noise = std::abs(Noise::sample(seed++, x, y));
+            sum += (noise * -2 + 1) * amp;
+            x *= fractal.lacunarity;
+            y *= fractal.lacunarity;
+            amp *= fractal.gain;
+        }
+        return sum;
+    }
+};
+
+int fractalOctaves(const NoiseLayer &layer) {
+    return layer.fractalType == FastNoiseLite::FractalType_None ? 1 : layer.octaves;
+}
+
+template <typename Noise>
+OctaveSplitPlan planSplit(const NoiseLayer &layer, const OctaveSplitParams &split,
+                          const TerrainKernel::ChunkLattice &lattice) {
+    OctaveSplitPlan best;
+    if (!split.enabled || lattice.cellsX < 2 || lattice.cellsY < 2) {
+        return best;
+    }
+    const int octaves = fractalOctaves(layer);
+    int eligible = 0;
+    for (float frequency = layer.frequency;
+         eligible < octaves && frequency < split.cutoffFrequency; ++eligible) {
+        frequency *= layer.lacunarity;
+    }
+
+    const float cells = static_cast<float>(lattice.cellCount());
+    const float firstAmplitude = layer.fractalType == FastNoiseLite::FractalType_None
+                                     ? 1.0f
+                                     : fractalBounding(layer.octaves, layer.gain);
+    float bestCost = static_cast<float>(octaves) * cells;
+    for (int spacing = 2; spacing <= std::max(lattice.cellsX, lattice.cellsY); spacing *= 2) {
+        const float coarsePoints =
+            static_cast<float>(((lattice.cellsX - 1) / spacing + 4)
+                               * ((lattice.cellsY - 1) / spacing + 4));
+        float amplitude = firstAmplitude;
+        float step = layer.frequency * static_cast<float>(lattice.cellStep * spacing);
+        float error = 0.0f;
+        for (int coarse = 1; coarse <= eligible; ++coarse) {
+            error += std::abs(amplitude) * Noise::upsampleError(step);
+            if (error > split.maxError) {
+                break;
+            }
+            const float cost = static_cast<float>(coarse) * coarsePoints
+                               + static_cast<float>(octaves - coarse) * cells
+                               + UPSAMPLE_COST * cells;
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = {coarse, spacing, error};
+            }
+            amplitude *= layer.gain;
+            step *= layer.lacunarity;
+        }
+    }
+    return best;
+}
+
+std::array<float, 4> catmullRomWeights(float t) {
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    return {0.5f * (-t3 + 2.0f * t2 - t), 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f),
+            0.5f * (-3.0f * t3 + 4.0f * t2 + t), 0.5f * (t3 - t2)};
+}
+
+// Evaluates the plan's coarse octaves every `spacing` lattice cells, with one extra point
+// before and two after each axis for the cubic's support, and upsamples them into `out`.
+template <typename Noise, typename FractalPolicy>
+void sampleCoarse(const Fractal &fractal, const OctaveSplitPlan &plan, float frequency,
+                  const TerrainKernel::ChunkLattice &lattice, float *out) {
+    const int spacing = plan.spacing;
+    const int countX = (lattice.cellsX - 1) / spacing + 4;
+    const int countY = (lattice.cellsY - 1) / spacing + 4;
+    Fractal coarse = fractal;
+    coarse.endOctave = plan.coarseOctaves;
+
+    thread_local std::vector<float> coarseX;
+    thread_local std::vector<float> coarseValues;
+    thread_local std::vector<float> columns;
+    coarseX.resize(static_cast<std::size_t>(countX));
+    for (int i = 0; i < countX; ++i) {
+        coarseX[i] = lattice.worldX((i - 1) * spacing) / lattice.cellSize * frequency;
+    }
+    coarseValues.resize(static_cast<std::size_t>(countX) * countY);
+    for (int j = 0; j < countY; ++j) {
+        const float noiseY = lattice.worldY((j - 1) * spacing) / lattice.cellSize * frequency;
+        float *row = coarseValues.data() + static_cast<std::size_t>(j) * countX;
+        for (int i = 0; i < countX; ++i) {
+            row[i] = FractalPolicy::template sample<Noise>(coarse, coarseX[i], noiseY);
+        }
+    }
+
+    std::vector<std::array<float, 4>> weights(static_cast<std::size_t>(spacing));
+    for (int phase = 0; phase < spacing; ++phase) {
+        weights[phase] =
+            catmullRomWeights(static_cast<float>(phase) / static_cast<float>(spacing));
+    }
+
+    // Upsample along x for every coarse row, then along y into the output.
+    columns.resize(static_cast<std::size_t>(countY) * lattice.cellsX);
+    for (int j = 0; j < countY; ++j) {
+        const float *source = coarseValues.data() + static_cast<std::size_t>(j) * countX;
+        float *row = columns.data() + static_cast<std::size_t>(j) * lattice.cellsX;
+        for (int x = 0; x < lattice.cellsX; ++x) {
+            const float *p = source + x / spacing;
+            const std::array<float, 4> &w = weights[x % spacing];
+            row[x] = w[0] * p[0] + w[1] * p[1] + w[2] * p[2] + w[3] * p[3];
+        }
+    }
+    const std::size_t stride = static_cast<std::size_t>(lattice.cellsX);
+    for (int y = 0; y < lattice.cellsY; ++y) {
+        const float *p = columns.data() + static_cast<std::size_t>(y / spacing) * stride;
+        const std::array<float, 4> &w = weights[y % spacing];
+        float *row = out + static_cast<std::size_t>(y) * stride;
+        for (int x = 0; x < lattice.cellsX; ++x) {
+            row[x] = w[0] * p[x] + w[1] * p[x + stride] + w[2] * p[x + 2 * stride]
+                     + w[3] * p[x + 3 * stride];
+        }
+    }
+}
+
+template <typename Noise, typename FractalPolicy>
+void sampleSpecialized(const FastNoiseLite &, const NoiseLayer &layer,
+                       const OctaveSplitParams &split,
+                       const TerrainKernel::ChunkLattice &lattice, float *out) {
+    Fractal fractal;
+    fractal.seed = layer.seed;
+    fractal.lacunarity = layer.lacunarity;
+    fractal.gain = layer.gain;
+    fractal.bounding = fractalBounding(layer.octaves, layer.gain);
+    fractal.endOctave = fractalOctaves(layer);
+
+    OctaveSplitPlan plan;
+    if constexpr (FractalPolicy::SPLITTABLE) {
+        plan = planSplit<Noise>(layer, split, lattice);
+    }
+    if (plan.coarseOctaves > 0) {
+        sampleCoarse<Noise, FractalPolicy>(fractal, plan, layer.frequency, lattice, out);
+        if (plan.coarseOctaves == fractal.endOctave) {
+            return;
+        }
+        fractal.firstOctave = plan.coarseOctaves;
+    }
+    const bool accumulate = plan.coarseOctaves > 0;
+
+    thread_local std::vector<float> noiseX;
+    thread_local std::vector<float> noiseY;
+    TerrainKernel::noiseCoordinates(lattice, layer.frequency, noiseX, noiseY);
+
+    for (int y = 0; y < lattice.cellsY; ++y) {
+        float *row = out + static_cast<std::size_t>(y) * lattice.cellsX;
+        for (int x = 0; x < lattice.cellsX; ++x) {
+            const float value =
+                FractalPolicy::template sample<Noise>(fractal, noiseX[x], noiseY[y]);
+            row[x] = accumulate ? row[x] + value : value;
+        }
+    }
+}
+
+void samplePerSample(const FastNoiseLite &noise, const NoiseLayer &, const OctaveSplitParams &,
+                     const TerrainKernel::ChunkLattice &lattice, float *out) {
+    TerrainKernel::sampleNoiseField(noise, lattice, out);
+}
+
+void sampleCellular(const FastNoiseLite &, const NoiseLayer &layer, const OctaveSplitParams &,
+                    const TerrainKernel::ChunkLattice &lattice, float *out) {
+    CellularNoise::sampleField(layer, lattice, out);
+}
+
+template <typename Noise>
+FieldSampler selectFractal(FastNoiseLite::FractalType fractalType) {
+    switch (fractalType) {
+    case FastNoiseLite::FractalType_None:
+        return &sampleSpecialized<Noise, NoFractal>;
+    case FastNoiseLite::FractalType_FBm:
+        return &sampleSpecialized<Noise, FBmFractal>;
+    case FastNoiseLite::FractalType_Ridged:
+        return &sampleSpecialized<Noise, RidgedFractal>;
+    default:
+        return nullptr;
+    }
+}
+
+FieldSampler selectSpecialized(const NoiseLayer &layer) {
+    switch (layer.noiseType) {
+    case FastNoiseLite::NoiseType_Perlin:
+        return selectFractal<PerlinNoise>(layer.fractalType);
+    case FastNoiseLite::NoiseType_Value:
+        return selectFractal<ValueNoise>(layer.fractalType);
+    case FastNoiseLite::NoiseType_Cellular:
+        return CellularNoise::supports(layer) ? &sampleCellular : nullptr;
+    default:
+        return nullptr;
+    }
+}
+
+}  // namespace
+
+FieldSampler select(const NoiseLayer &layer, Backend backend) {
+    if (backend == Backend::Specialized) {
+        if (FieldSampler sampler = selectSpecialized(layer)) {
+            return sampler;
+        }
+    }
+    return &samplePerSample;
+}
+
+bool isSpecialized(const NoiseLayer &layer) {
+    return selectSpecialized(layer) != nullptr;
+}
+
+const char *backendName(Backend backend) {
+    return backend == Backend::Specialized ? "Specialized" : "Per-Sample";
+}
+
+bool supportsOctaveSplit(const NoiseLayer &layer) {
+    const bool smoothNoise = layer.noiseType == FastNoiseLite::NoiseType_Perlin
+                             || layer.noiseType == FastNoiseLite::NoiseType_Value;
+    const bool smoothFractal = layer.fractalType == FastNoiseLite::FractalType_None
+                               || layer.fractalType == FastNoiseLite::FractalType_FBm;
+    return smoothNoise && smoothFractal;
+}
+
+OctaveSplitPlan planOctaveSplit(const NoiseLayer &layer, const OctaveSplitParams &split,
+                                const TerrainKernel::ChunkLattice &lattice) {
+    if (!supportsOctaveSplit(layer)) {
+        return {};
+    }
+    return layer.noiseType == FastNoiseLite::NoiseType_Perlin
+               ? planSplit<PerlinNoise>(layer, split, lattice)
+               : planSplit<ValueNoise>(layer, split, lattice);
+}
+
+BenchmarkResult benchmark(const FastNoiseLite &noise, const NoiseLayer &layer,
+                          const OctaveSplitParams &split, int cells, int repetitions) {
+    BenchmarkResult result;
+    const TerrainKernel::ChunkLattice lattice = NoiseBenchmark::squareLattice(cells);
+    result.samples = lattice.cellCount();
+
+    const FieldSampler perSample = select(layer, Backend::PerSample);
+    const FieldSampler specialized = select(layer, Backend::Specialized);
+    const std::size_t cellCount = static_cast<std::size_t>(lattice.cellCount());
+    const OctaveSplitParams noSplit;
+    std::vector<float> reference(cellCount);
+    std::vector<float> values(cellCount);
+    for (int i = 0; i < repetitions; ++i) {
+        result.perSampleMs += NoiseBenchmark::millisecondsFor(
+            [&]() { perSample(noise, layer, noSplit, lattice, reference.data()); });
+        result.specializedMs += NoiseBenchmark::millisecondsFor(
+            [&]() { specialized(noise, layer, noSplit, lattice, values.data()); });
+    }
+    result.maxDifference = NoiseBenchmark::maxDifference(values, reference);
+
+    result.splitPlan = planOctaveSplit(layer, split, lattice);
+    if (result.splitPlan.coarseOctaves == 0) {
+        return result;
+    }
+    for (int i = 0; i < repetitions; ++i) {
+        result.splitMs += NoiseBenchmark::millisecondsFor(
+            [&]() { specialized(noise, layer, split, lattice, values.data()); });
+    }
+    result.splitMaxDifference = NoiseBenchmark::maxDifference(values, reference);
+    return result;
+}
+
+}  // namespace NoisePipeline
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "FastNoiseLite.h"
+#include "world/TerrainKernel.h"
+
+struct NoiseLayer;
+struct OctaveSplitParams;
+
+// Per-layer noise field sampling, chosen once per snapshot. The specialized backend has a
+// sampler instantiated for each supported (noise type, fractal type) pair, with the noise
+// function and octave loop inlined, so no sample goes through the runtime switches in
+// FastNoiseLite::GetNoise. The per-sample backend calls GetNoise for every layer and is
+// kept for comparison. Both produce the same values.
+namespace NoisePipeline {
+
+enum class Backend {
+    PerSample,
+    Specialized,
+};
+
+// Writes the noise of a generator configured from `layer` for every lattice cell into
+// `out`, as TerrainKernel::sampleNoiseField would for `noise`. Specialized samplers follow
+// `split` and may upsample low octaves; the output then differs by at most its error bound.
+using FieldSampler = void (*)(const FastNoiseLite &noise, const NoiseLayer &layer,
+                              const OctaveSplitParams &split,
+                              const TerrainKernel::ChunkLattice &lattice, float *out);
+
+// The sampler for `layer` under `backend`. Layers without a specialization sample per cell.
+FieldSampler select(const NoiseLayer &layer, Backend backend);
+
+bool isSpecialized(const NoiseLayer &layer);
+
+const char *backendName(Backend backend);
+
+// How a layer's octaves are divided for one lattice: the first `coarseOctaves` are evaluated
+// every `spacing` cells and upsampled, the rest at every cell.
+struct OctaveSplitPlan {
+    int coarseOctaves = 0;
+    int spacing = 1;
+    float estimatedError = 0.0f;
+};
+
+// True when the specialized sampler for `layer` can upsample its low octaves. Ridged and
+// cellular noise are not smooth enough to interpolate.
+bool supportsOctaveSplit(const NoiseLayer &layer);
+
+// The cheapest split of `layer` over `lattice` whose estimated error stays within
+// `split.maxError`. No octaves are upsampled when splitting would not save work.
+OctaveSplitPlan planOctaveSplit(const NoiseLayer &layer, const OctaveSplitParams &split,
+                                const TerrainKernel::ChunkLattice &lattice);
+
+struct BenchmarkResult {
+    int samples = 0;
+    double perSampleMs = 0.0;
+    double specializedMs = 0.0;
+    float maxDifference = 0.0f;
+    // Only timed when `split` upsamples any octave of the benchmark lattice.
+    OctaveSplitPlan splitPlan;
+    double splitMs = 0.0;
+    float splitMaxDifference = 0.0f;
+};
+
+// Times `repetitions` passes of both backends over a `cells` x `cells` lattice, and of the
+// specialized backend under `split`.
+BenchmarkResult benchmark(const FastNoiseLite &noise, const NoiseLayer &layer,
+                          const OctaveSplitParams &split, int cells, int repetitions);
+
+}  // namespace NoisePipeline
@@ -0,0 +1,275 @@
+#pragma once
+
+#include "world/TerrainType.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Terrain types packed four cells to a byte, two bits each. Cells are read by index like a
+// vector and written through set(). While every cell holds the same type only that type is
+// stored; the first differing set() expands it to per-cell storage.
+class PackedTerrainCells {
+public:
+    PackedTerrainCells() = default;
+    explicit PackedTerrainCells(std::size_t count, TerrainType fill = TerrainType::WATER) {
+        assign(count, fill);
+    }
+
+    // Every cell becomes `fill`, stored without per-cell bytes.
+    void assign(std::size_t count, TerrainType fill) {
+        _count = count;
+        _fill = fill;
+        _bytes.clear();
+        _bytes.shrink_to_fit();
+    }
+
+    void assign(const TerrainType *types, std::size_t count) {
+        assign(count, count > 0 ? types[0] : TerrainType::WATER);
+        for (std::size_t i = 1; i < count; ++i) {
+            set(i, types[i]);
+        }
+    }
+
+    // Takes `count` cells written by copyBytes(); returns false if the size is wrong.
+    bool assignBytes(std::vector<std::uint8_t> bytes, std::size_t count) {
+        if (bytes.size() != byteCountFor(count)) {
+            return false;
+        }
+        _bytes = std::move(bytes);
+        _count = count;
+        compact();
+        return true;
+    }
+
+    void clear() { assign(0, TerrainType::WATER); }
+
+    TerrainType operator[](std::size_t index) const {
+        if (_bytes.empty()) {
+            return _fill;
+        }
+        const unsigned shift = (index % CELLS_PER_BYTE) * BITS_PER_CELL;
+        return static_cast<TerrainType>((_bytes[index / CELLS_PER_BYTE] >> shift) & CODE_MASK);
+    }
+
+    void set(std::size_t index, TerrainType type) {
+        if (_bytes.empty()) {
+            if (type == _fill) {
+                return;
+            }
+            expand();
+        }
+        const unsigned shift = (index % CELLS_PER_BYTE) * BITS_PER_CELL;
+        std::uint8_t &byte = _bytes[index / CELLS_PER_BYTE];
+        byte = static_cast<std::uint8_t>((byte & ~(CODE_MASK << shift))
+                                         | ((static_cast<std::uint8_t>(type) & CODE_MASK)
+                                            << shift));
+    }
+
+    // Gives every cell its own storage. Needed before threads set() disjoint ranges of one
+    // buffer concurrently, since expanding on the first differing set() is not thread-safe.
+    void expand() {
+        if (_bytes.empty()) {
+            _bytes.assign(byteCountFor(_count), fillByte(_fill));
+        }
+    }
+
+    // Drops the per-cell bytes if every cell turned out to hold the same type.
+    void compact() {
+        if (_bytes.empty() || _count == 0) {
+            return;
+        }
+        const TerrainType first = (*this)[0];
+        for (std::size_t i = 1; i < _count; ++i) {
+            if ((*this)[i] != first) {
+                return;
+            }
+        }
+        assign(_count, first);
+    }
+
+    // Writes the packed form of every cell, uniform or not, to `out`.
+    void copyBytes(std::uint8_t *out) const {
+        if (_bytes.empty()) {
+            std::memset(out, fillByte(_fill), byteCountFor(_count));
+        } else {
+            std::memcpy(out, _bytes.data(), _bytes.size());
+        }
+    }
+
+    std::size_t size() const noexcept { return _count; }
+    bool empty() const noexcept { return _count == 0; }
+    bool isUniform() const noexcept { return _bytes.empty(); }
+    // Bytes held for the cells themselves; zero while uniform.
+    std::size_t byteSize() const noexcept { return _bytes.size(); }
+
+    bool operator==(const PackedTerrainCells &other) const {
+        if (_count != other._count) {
+            return false;
+        }
+        if (!_bytes.empty() && !other._bytes.empty()) {
+            return _bytes == other._bytes;
+        }
+        for (std::size_t i = 0; i < _count; ++i) {
+            if ((*this)[i] != other[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const PackedTerrainCells &other) const { return !(*this == other); }
+
+    static constexpr std::size_t byteCountFor(std::size_t count) {
+        return (count + CELLS_PER_BYTE - 1) / CELLS_PER_BYTE;
+    }
+
+    // Threads writing one buffer concurrently must each own whole bytes, i.e. ranges that
+    // start on a multiple of this many cells.
+    static constexpr std::size_t CELLS_PER_BYTE = 4;
+
+private:
+    static constexpr unsigned BITS_PER_CELL = 2;
+    static constexpr std::uint8_t CODE_MASK = 0x3;
+
+    static std::uint8_t fillByte(TerrainType type) {
+        return static_cast<std::uint8_t>((static_cast<std::uint8_t>(type) & CODE_MASK) * 0x55);
+    }
+
+    std::vector<std::uint8_t> _bytes;
+    std::size_t _count = 0;
+    TerrainType _fill = TerrainType::WATER;
+};
+
+// Elevations stored as 16-bit fractions of the maximum elevation they were packed with,
+// which keeps the error below maxElevation / 131070. Like PackedTerrainCells, a chunk at
+// one elevation stores only that value.
+class QuantizedElevations {
+public:
+    QuantizedElevations() = default;
+
+    // All cells start at zero, stored without per-cell values.
+    void assign(std::size_t count, float maxElevation) {
+        setMaxElevation(maxElevation);
+        _count = count;
+        _fill = 0;
+        _values.clear();
+        _values.shrink_to_fit();
+    }
+
+    void assign(const float *values, std::size_t count, float maxElevation) {
+        assign(count, maxElevation);
+        if (count > 0) {
+            _fill = quantize(values[0]);
+        }
+        for (std::size_t i = 1; i < count; ++i) {
+            set(i, values[i]);
+        }
+    }
+
+    // Takes values written by copyValues(); returns false if the size is wrong.
+    bool assignValues(std::vector<std::uint16_t> values, std::size_t count,
+                      float maxElevation) {
+        if (values.size() != count) {
+            return false;
+        }
+        setMaxElevation(maxElevation);
+        _values = std::move(values);
+        _count = count;
+        compact();
+        return true;
+    }
+
+    void clear() { assign(0, _maxElevation); }
+
+    float operator[](std::size_t index) const {
+        return static_cast<float>(_values.empty() ? _fill : _values[index]) * _step;
+    }
+
+    void set(std::size_t index, float elevation) {
+        const std::uint16_t value = quantize(elevation);
+        if (_values.empty()) {
+            if (value == _fill) {
+                return;
+            }
+            expand();
+        }
+        _values[index] = value;
+    }
+
+    // See PackedTerrainCells::expand().
+    void expand() {
+        if (_values.empty()) {
+            _values.assign(_count, _fill);
+        }
+    }
+
+    // Drops the per-cell values if every cell turned out to hold the same one.
+    void compact() {
+        if (_values.empty() || _count == 0) {
+            return;
+        }
+        if (std::all_of(_values.begin(), _values.end(),
+                        [first = _values[0]](std::uint16_t value) { return value == first; })) {
+            const std::uint16_t first = _values[0];
+            assign(_count, _maxElevation);
+            _fill = first;
+        }
+    }
+
+    // Writes every cell's 16-bit value, uniform or not, to `out`.
+    void copyValues(std::uint16_t *out) const {
+        if (_values.empty()) {
+            std::fill(out, out + _count, _fill);
+        } else {
+            std::memcpy(out, _values.data(), _values.size() * sizeof(std::uint16_t));
+        }
+    }
+
+    std::size_t size() const noexcept { return _count; }
+    bool empty() const noexcept { return _count == 0; }
+    bool isUniform() const noexcept { return _values.empty(); }
+    // Bytes held for the cells themselves; zero while uniform.
+    std::size_t byteSize() const noexcept { return _values.size() * sizeof(std::uint16_t); }
+    float getMaxElevation() const noexcept { return _maxElevation; }
+
+private:
+    static constexpr float QUANTUM_MAX = 65535.0f;
+
+    void setMaxElevation(float maxElevation) {
+        _maxElevation = std::max(0.0f, maxElevation);
+        _step = _maxElevation / QUANTUM_MAX;
+        _inverseStep = _maxElevation > 0.0f ? QUANTUM_MAX / _maxElevation : 0.0f;
+    }
+
+    std::uint16_t quantize(float elevation) const {
+        const float scaled = std::round(elevation * _inverseStep);
+        return static_cast<std::uint16_t>(std::clamp(scaled, 0.0f, QUANTUM_MAX));
+    }
+
+    std::vector<std::uint16_t> _values;
+    std::size_t _count = 0;
+    std::uint16_t _fill = 0;
+    float _maxElevation = 0.0f;
+    float _step = 0.0f;
+    float _inverseStep = 0.0f;
+};
+
+// Read-only 2D access to one chunk's cells, row-major with `cellsX` cells per row.
+struct ChunkCellsView {
+    const PackedTerrainCells &terrain;
+    const QuantizedElevations &elevations;
+    int cellsX = 0;
+    int cellsY = 0;
+
+    bool contains(int x, int y) const {
+        return x >= 0 && y >= 0 && x < cellsX && y < cellsY
+               && static_cast<std::size_t>(y * cellsX + x) < terrain.size()
+               && static_cast<std::size_t>(y * cellsX + x) < elevations.size();
+    }
+    TerrainType terrainAt(int x, int y) const { return terrain[y * cellsX + x]; }
+    float elevationAt(int x, int y) const { return elevations[y * cellsX + x]; }
+    // True when every cell shares one terrain type and one elevation.
+    bool isUniform() const { return terrain.isUniform() && elevations.isUniform(); }
+};
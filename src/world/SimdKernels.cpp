@@ -0,0 +1,67 @@
+#include "SimdKernels.h"
+#include "Logger.h"
+#include "core/CpuFeatures.h"
+#include "world/SimdKernelsImpl.h"
+
+namespace SimdKernels {
+
+namespace {
+
+using TerrainKernel::ScalarLanes;
+using TerrainKernel::WideLanes;
+
+#if defined(__AVX2__)
+constexpr const char *BASELINE_NAME = "AVX2 (baseline)";
+#elif defined(__SSE2__) || defined(_M_X64)
+constexpr const char *BASELINE_NAME = "SSE2";
+#else
+constexpr const char *BASELINE_NAME = "Scalar";
+#endif
+
+void combineTerrain(const ShapeParams &shape, const TerrainRow &row, int begin, int end) {
+    begin = combineTerrainSpan<WideLanes>(shape, row, begin, end);
+    combineTerrainSpan<ScalarLanes>(shape, row, begin, end);
+}
+
+void sampleCellularRow(const CellularRow &row, int begin, int end) {
+    begin = cellularSpan<WideLanes>(row, begin, end);
+    cellularSpan<ScalarLanes>(row, begin, end);
+}
+
+void combineSuitability(const SuitabilitySpan &span, int begin, int end) {
+    begin = suitabilitySpan<WideLanes>(span, begin, end);
+    suitabilitySpan<ScalarLanes>(span, begin, end);
+}
+
+void reliefLighting(const ReliefRow &row, int begin, int end) {
+    begin = reliefSpan<WideLanes>(row, begin, end);
+    reliefSpan<ScalarLanes>(row, begin, end);
+}
+
+const Table &selectTable() {
+    const CpuFeatures &features = cpuFeatures();
+    const Table *table = &baselineTable();
+#ifdef TRANSITY_AVX2_KERNELS
+    if (features.avx2) {
+        table = &avx2Table();
+    }
+#endif
+    LOG_INFO("SimdKernels", "CPU supports %s; using %s kernels.", features.describe().c_str(),
+             table->name);
+    return *table;
+}
+
+}  // namespace
+
+const Table &baselineTable() {
+    static const Table table{BASELINE_NAME, &combineTerrain, &sampleCellularRow,
+                             &combineSuitability, &reliefLighting};
+    return table;
+}
+
+const Table &active() {
+    static const Table &table = selectTable();
+    return table;
+}
+
+}  // namespace SimdKernels
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "world/TerrainKernel.h"
+#include "world/TerrainType.h"
+#include <cstddef>
+
+// The lane-parallel inner loops of terrain generation, city suitability and terrain
+// meshing. Each is compiled once at the build's baseline instruction set and again in a
+// translation unit of its own for every wider set the build enables; active() picks the
+// widest the CPU supports. Every variant produces the same values.
+namespace SimdKernels {
+
+// One lattice row for TerrainKernel::combineFields.
+struct TerrainRow {
+    const float *worldX = nullptr;
+    float dy2 = 0.0f;
+    bool hasWeight = false;
+    // Index of the row's first cell in the fields and outputs.
+    int rowOffset = 0;
+    const float *const *layerFields = nullptr;
+    const float *layerWeights = nullptr;
+    std::size_t layerCount = 0;
+    float totalWeight = 0.0f;
+    const float *distortionField = nullptr;
+    TerrainType *outTerrain = nullptr;
+    float *outElevation = nullptr;
+};
+
+// One lattice row of single-octave cellular noise. Samples share the row's rounded y; the
+// feature offsets cover every noise cell the samples can reach, `gridWidth` per grid row.
+struct CellularRow {
+    const float *offsetX = nullptr;
+    const float *offsetY = nullptr;
+    int gridFirstX = 0;
+    int gridFirstY = 0;
+    int gridWidth = 0;
+    // Per-sample x, x rounded the way FastNoiseLite rounds it, and the same as a float.
+    const float *xs = nullptr;
+    const int *xr = nullptr;
+    const float *roundedXs = nullptr;
+    float y = 0.0f;
+    int yr = 0;
+    float *out = nullptr;
+};
+
+// Weighted suitability combination over a run of cells. `land` holds 1 for land cells and 0
+// otherwise; every non-land cell scores zero.
+struct SuitabilitySpan {
+    const float *land = nullptr;
+    const float *water = nullptr;
+    const float *expandability = nullptr;
+    const float *noise = nullptr;
+    const float *cityProximity = nullptr;
+    const float *townProximity = nullptr;
+    const float *suburbProximity = nullptr;
+    float waterWeight = 0.0f;
+    float expandabilityWeight = 0.0f;
+    float noiseWeight = 0.0f;
+    float proximityWeight = 0.0f;
+    float *outFinal = nullptr;
+    float *outTown = nullptr;
+    float *outSuburb = nullptr;
+};
+
+// Relief lighting for one row of a chunk mesh. `center` must also be readable at -1 and at
+// the row length, holding the edge cells' own elevations there, as must `up` and `down`
+// hold the row's own elevations at the chunk's top and bottom edges.
+struct ReliefRow {
+    const float *up = nullptr;
+    const float *center = nullptr;
+    const float *down = nullptr;
+    float twoCellSize = 1.0f;
+    float maxElevation = 1.0f;
+    float lightX = 0.0f;
+    float lightY = 0.0f;
+    float lightZ = 1.0f;
+    float *outLighting = nullptr;
+    float *outNormalizedElevation = nullptr;
+};
+
+// One implementation of every kernel. Each processes elements [begin, end) of its row.
+struct Table {
+    const char *name;
+    void (*combineTerrain)(const TerrainKernel::ShapeParams &shape, const TerrainRow &row,
+                           int begin, int end);
+    void (*sampleCellularRow)(const CellularRow &row, int begin, int end);
+    void (*combineSuitability)(const SuitabilitySpan &span, int begin, int end);
+    void (*reliefLighting)(const ReliefRow &row, int begin, int end);
+};
+
+// Compiled at the baseline instruction set, so it runs everywhere the binary does.
+const Table &baselineTable();
+
+#ifdef TRANSITY_AVX2_KERNELS
+// Compiled with AVX2 enabled; only valid when the CPU supports it.
+const Table &avx2Table();
+#endif
+
+// The widest table this CPU supports, chosen and logged on first use.
+const Table &active();
+
+}  // namespace SimdKernels
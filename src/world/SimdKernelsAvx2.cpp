@@ -0,0 +1,46 @@
+// Built with AVX2 code generation enabled (see CMakeLists.txt); nothing in this file may run
+// before active() has confirmed the CPU supports it.
+#include "SimdKernels.h"
+
+#ifdef TRANSITY_AVX2_KERNELS
+
+#include "world/SimdKernelsImpl.h"
+
+namespace SimdKernels {
+
+namespace {
+
+using TerrainKernel::Avx2Lanes;
+
+// Each kernel hands the final partial lane group to the baseline table.
+void combineTerrain(const ShapeParams &shape, const TerrainRow &row, int begin, int end) {
+    begin = combineTerrainSpan<Avx2Lanes>(shape, row, begin, end);
+    baselineTable().combineTerrain(shape, row, begin, end);
+}
+
+void sampleCellularRow(const CellularRow &row, int begin, int end) {
+    begin = cellularSpan<Avx2Lanes>(row, begin, end);
+    baselineTable().sampleCellularRow(row, begin, end);
+}
+
+void combineSuitability(const SuitabilitySpan &span, int begin, int end) {
+    begin = suitabilitySpan<Avx2Lanes>(span, begin, end);
+    baselineTable().combineSuitability(span, begin, end);
+}
+
+void reliefLighting(const ReliefRow &row, int begin, int end) {
+    begin = reliefSpan<Avx2Lanes>(row, begin, end);
+    baselineTable().reliefLighting(row, begin, end);
+}
+
+}  // namespace
+
+const Table &avx2Table() {
+    static const Table table{"AVX2", &combineTerrain, &sampleCellularRow, &combineSuitability,
+                             &reliefLighting};
+    return table;
+}
+
+}  // namespace SimdKernels
+
+#endif
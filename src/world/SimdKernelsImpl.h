@@ -0,0 +1,274 @@
+#pragma once
+
+#include "world/SimdKernels.h"
+#include "world/SimdLanes.h"
+#include <cfloat>
+#include <cstddef>
+
+// Lane-generic bodies of the SimdKernels, included by each translation unit that compiles a
+// kernel table. Everything here has internal linkage, so functions compiled for a wider
+// instruction set can never be merged with, and replace, the baseline copies at link time.
+// For the same reason the bodies use only lane operations and plain arithmetic, never
+// standard library templates. Each span processes whole lane groups from `begin` and
+// returns the index it stopped at.
+namespace SimdKernels {
+
+namespace {
+
+using TerrainKernel::ShapeParams;
+
+// Cephes-style logf/exp2f coefficients; accurate to a few ulp on the reduced ranges.
+constexpr float SQRT_HALF = 0.707106781186547524f;
+constexpr float LOG2_E = 1.44269504088896341f;
+constexpr float LOG_P0 = 7.0376836292e-2f;
+constexpr float LOG_P1 = -1.1514610310e-1f;
+constexpr float LOG_P2 = 1.1676998740e-1f;
+constexpr float LOG_P3 = -1.2420140846e-1f;
+constexpr float LOG_P4 = 1.4249322787e-1f;
+constexpr float LOG_P5 = -1.6668057665e-1f;
+constexpr float LOG_P6 = 2.0000714765e-1f;
+constexpr float LOG_P7 = -2.4999993993e-1f;
+constexpr float LOG_P8 = 3.3333331174e-1f;
+constexpr float LOG_Q1 = -2.12194440e-4f;
+constexpr float LOG_Q2 = 0.693359375f;
+constexpr float EXP2_P0 = 1.535336188319500e-4f;
+constexpr float EXP2_P1 = 1.339887440266574e-3f;
+constexpr float EXP2_P2 = 9.618437357674640e-3f;
+constexpr float EXP2_P3 = 5.550332471162809e-2f;
+constexpr float EXP2_P4 = 2.402264791363012e-1f;
+constexpr float EXP2_P5 = 6.931472028550421e-1f;
+
+// Squared cellular distance no feature point can exceed.
+constexpr float NO_DISTANCE = 1e10f;
+
+// Relief lighting: ambient, diffuse and elevation terms and the clamp range.
+constexpr float RELIEF_AMBIENT = 0.35f;
+constexpr float RELIEF_DIFFUSE = 0.55f;
+constexpr float RELIEF_ELEVATION = 0.25f;
+constexpr float RELIEF_MIN = 0.25f;
+constexpr float RELIEF_MAX = 1.3f;
+
+// pow(base, exponent) as exp2(exponent * log2(base)). Lanes with base <= 0 return 0,
+// which is what the elevation curve needs at the coastline.
+template <typename L>
+typename L::Float lanePow(typename L::Float base, typename L::Float exponent) {
+    using F = typename L::Float;
+    using I = typename L::Int;
+
+    const F positive = L::greaterThan(base, L::set(0.0f));
+    const F x0 = L::max(base, L::set(FLT_MIN));
+
+    // Split into mantissa in [0.5, 1) and exponent, as frexpf does.
+    const I bits = L::floatToBits(x0);
+    I e = L::subInt(L::shiftRight(bits, 23), L::setInt(126));
+    F m = L::bitsToFloat(L::orInt(L::andInt(bits, L::setInt(0x007FFFFF)), L::setInt(0x3F000000)));
+    F ef = L::intToFloat(e);
+
+    const F small = L::lessThan(m, L::set(SQRT_HALF));
+    ef = L::sub(ef, L::bitAnd(small, L::set(1.0f)));
+    F x = L::add(L::sub(m, L::set(1.0f)), L::bitAnd(small, m));
+
+    const F z = L::mul(x, x);
+    F y = L::set(LOG_P0);
+    y = L::add(L::mul(y, x), L::set(LOG_P1));
+    y = L::add(L::mul(y, x), L::set(LOG_P2));
+    y = L::add(L::mul(y, x), L::set(LOG_P3));
+    y = L::add(L::mul(y, x), L::set(LOG_P4));
+    y = L::add(L::mul(y, x), L::set(LOG_P5));
+    y = L::add(L::mul(y, x), L::set(LOG_P6));
+    y = L::add(L::mul(y, x), L::set(LOG_P7));
+    y = L::add(L::mul(y, x), L::set(LOG_P8));
+    y = L::mul(L::mul(y, x), z);
+    y = L::add(y, L::mul(ef, L::set(LOG_Q1)));
+    y = L::sub(y, L::mul(z, L::set(0.5f)));
+    const F ln = L::add(L::add(x, y), L::mul(ef, L::set(LOG_Q2)));
+
+    F t = L::mul(L::mul(ln, exponent), L::set(LOG2_E));
+    t = L::max(t, L::set(-126.0f));
+
+    const I n = L::roundToInt(t);
+    const F f = L::sub(t, L::intToFloat(n));
+    F p = L::set(EXP2_P0);
+    p = L::add(L::mul(p, f), L::set(EXP2_P1));
+    p = L::add(L::mul(p, f), L::set(EXP2_P2));
+    p = L::add(L::mul(p, f), L::set(EXP2_P3));
+    p = L::add(L::mul(p, f), L::set(EXP2_P4));
+    p = L::add(L::mul(p, f), L::set(EXP2_P5));
+    p = L::add(L::mul(p, f), L::set(1.0f));
+
+    const F scale = L::bitsToFloat(L::shiftLeft(L::addInt(n, L::setInt(127)), 23));
+    return L::bitAnd(positive, L::mul(p, scale));
+}
+
+template <typename L>
+int combineTerrainSpan(const ShapeParams &shape, const TerrainRow &row, int begin, int end) {
+    using F = typename L::Float;
+
+    const F centerX = L::set(shape.centerX);
+    const F dy2 = L::set(row.dy2);
+    const F maxDistance = L::set(shape.maxDistance);
+    const F one = L::set(1.0f);
+    const F zero = L::set(0.0f);
+    const F weightSum = L::set(row.totalWeight);
+    const F threshold = L::set(shape.landThreshold);
+    const F strength = L::set(shape.distortionStrength);
+    const F minDenominator = L::set(0.0001f);
+    const F exponent = L::set(shape.elevationExponent);
+    const F maxElevation = L::set(shape.maxElevation);
+    const bool linearElevation = shape.elevationExponent == 1.0f;
+
+    alignas(32) float landMask[L::WIDTH];
+    alignas(32) float elevations[L::WIDTH];
+
+    int x = begin;
+    for (; x + L::WIDTH <= end; x += L::WIDTH) {
+        const int cell = row.rowOffset + x;
+
+        const F dx = L::sub(centerX, L::load(row.worldX + x));
+        const F distance = L::sqrt(L::add(L::mul(dx, dx), dy2));
+        const F falloff = L::sub(one, L::min(one, L::div(distance, maxDistance)));
+
+        F combined = zero;
+        for (std::size_t layer = 0; layer < row.layerCount; ++layer) {
+            const F raw = L::load(row.layerFields[layer] + cell);
+            const F remapped = L::div(L::add(raw, one), L::set(2.0f));
+            combined = L::add(combined, L::mul(remapped, L::set(row.layerWeights[layer])));
+        }
+        if (row.hasWeight) {
+            combined = L::div(combined, weightSum);
+        }
+
+        const F finalValue = L::mul(combined, falloff);
+
+        F cellThreshold = threshold;
+        if (row.distortionField) {
+            const F distortion = L::load(row.distortionField + cell);
+            cellThreshold = L::add(cellThreshold, L::mul(distortion, strength));
+        }
+
+        const F isLand = L::greaterThan(finalValue, cellThreshold);
+        F elevation = zero;
+        if (L::anySet(isLand)) {
+            const F denominator = L::max(minDenominator, L::sub(one, cellThreshold));
+            F ratio = L::div(L::sub(finalValue, cellThreshold), denominator);
+            ratio = L::min(L::max(ratio, zero), one);
+            const F normalized = linearElevation ? ratio : lanePow<L>(ratio, exponent);
+            elevation = L::bitAnd(isLand, L::mul(normalized, maxElevation));
+        }
+
+        L::store(landMask, L::bitAnd(isLand, one));
+        L::store(elevations, elevation);
+        for (int lane = 0; lane < L::WIDTH; ++lane) {
+            row.outTerrain[cell + lane] =
+                landMask[lane] != 0.0f ? TerrainType::LAND : TerrainType::WATER;
+            row.outElevation[cell + lane] = elevations[lane];
+        }
+    }
+    return x;
+}
+
+// The lanes share the row's rounded y, so every candidate column of feature points is
+// tested against all lanes at once, and each lane only keeps distances to columns within
+// one of its own rounded x. Candidates are visited in FastNoiseLite's order.
+template <typename L>
+int cellularSpan(const CellularRow &row, int begin, int end) {
+    using F = typename L::Float;
+    const F one = L::set(1.0f);
+    int x = begin;
+    for (; x + L::WIDTH <= end; x += L::WIDTH) {
+        const F sampleX = L::load(row.xs + x);
+        const F sampleRoundedX = L::load(row.roundedXs + x);
+        const int firstXr = row.xr[x];
+        const int lastXr = row.xr[x + L::WIDTH - 1];
+        const int firstColumn = (firstXr < lastXr ? firstXr : lastXr) - 1;
+        const int lastColumn = (firstXr < lastXr ? lastXr : firstXr) + 1;
+
+        F distance0 = L::set(NO_DISTANCE);
+        for (int xi = firstColumn; xi <= lastColumn; ++xi) {
+            const float column = static_cast<float>(xi);
+            const F inReach = L::bitAnd(L::greaterThan(sampleRoundedX, L::set(column - 2.0f)),
+                                        L::lessThan(sampleRoundedX, L::set(column + 2.0f)));
+            const F toColumn = L::sub(L::set(column), sampleX);
+            for (int yi = row.yr - 1; yi <= row.yr + 1; ++yi) {
+                const std::size_t index =
+                    static_cast<std::size_t>(yi - row.gridFirstY) * row.gridWidth
+                    + (xi - row.gridFirstX);
+                const F vecX = L::add(toColumn, L::set(row.offsetX[index]));
+                const float vecY = (static_cast<float>(yi) - row.y) + row.offsetY[index];
+                const F distance = L::add(L::mul(vecX, vecX), L::set(vecY * vecY));
+                distance0 = L::select(inReach, L::min(distance0, distance), distance0);
+            }
+        }
+        L::store(row.out + x, L::sub(distance0, one));
+    }
+    return x;
+}
+
+template <typename L>
+int suitabilitySpan(const SuitabilitySpan &span, int begin, int end) {
+    using F = typename L::Float;
+    const F zero = L::set(0.0f);
+    const F waterWeight = L::set(span.waterWeight);
+    const F expandabilityWeight = L::set(span.expandabilityWeight);
+    const F noiseWeight = L::set(span.noiseWeight);
+    const F proximityWeight = L::set(span.proximityWeight);
+    int i = begin;
+    for (; i + L::WIDTH <= end; i += L::WIDTH) {
+        const F isLand = L::greaterThan(L::load(span.land + i), zero);
+        const F base =
+            L::add(L::add(L::mul(L::load(span.water + i), waterWeight),
+                          L::mul(L::load(span.expandability + i), expandabilityWeight)),
+                   L::mul(L::load(span.noise + i), noiseWeight));
+        L::store(span.outFinal + i,
+                 L::bitAnd(isLand, L::add(base, L::mul(L::load(span.cityProximity + i),
+                                                       proximityWeight))));
+        L::store(span.outTown + i,
+                 L::bitAnd(isLand, L::add(base, L::mul(L::load(span.townProximity + i),
+                                                       proximityWeight))));
+        L::store(span.outSuburb + i,
+                 L::bitAnd(isLand, L::add(base, L::mul(L::load(span.suburbProximity + i),
+                                                       proximityWeight))));
+    }
+    return i;
+}
+
+template <typename L>
+int reliefSpan(const ReliefRow &row, int begin, int end) {
+    using F = typename L::Float;
+    const F zero = L::set(0.0f);
+    const F one = L::set(1.0f);
+    const F twoCellSize = L::set(row.twoCellSize);
+    const F maxElevation = L::set(row.maxElevation);
+    const F lightX = L::set(row.lightX);
+    const F lightY = L::set(row.lightY);
+    const F lightZ = L::set(row.lightZ);
+    int x = begin;
+    for (; x + L::WIDTH <= end; x += L::WIDTH) {
+        const F center = L::load(row.center + x);
+        const F normalized = L::min(L::max(L::div(center, maxElevation), zero), one);
+
+        // The surface normal is (-dx, -dy, 1) normalised.
+        const F dx = L::div(L::sub(L::load(row.center + x + 1), L::load(row.center + x - 1)),
+                            twoCellSize);
+        const F dy = L::div(L::sub(L::load(row.down + x), L::load(row.up + x)), twoCellSize);
+        const F length = L::sqrt(L::add(L::add(L::mul(dx, dx), L::mul(dy, dy)), one));
+        const F normalX = L::div(L::sub(zero, dx), length);
+        const F normalY = L::div(L::sub(zero, dy), length);
+        const F normalZ = L::div(one, length);
+
+        const F dot = L::add(L::add(L::mul(normalX, lightX), L::mul(normalY, lightY)),
+                             L::mul(normalZ, lightZ));
+        const F diffuse = L::max(dot, zero);
+        const F lighting =
+            L::add(L::add(L::set(RELIEF_AMBIENT), L::mul(L::set(RELIEF_DIFFUSE), diffuse)),
+                   L::mul(L::set(RELIEF_ELEVATION), normalized));
+        L::store(row.outLighting + x,
+                 L::min(L::max(lighting, L::set(RELIEF_MIN)), L::set(RELIEF_MAX)));
+        L::store(row.outNormalizedElevation + x, normalized);
+    }
+    return x;
+}
+
+}  // namespace
+
+}  // namespace SimdKernels
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// SIMD lane wrappers shared by the batched terrain kernels. Each struct exposes the same
+// static operations over WIDTH floats, so kernels are written once as templates and
+// instantiated for the scalar tail and the widest instruction set the translation unit is
+// compiled for. SimdKernels builds one set at the baseline and one per runtime-dispatched
+// instruction set.
+namespace TerrainKernel {
+
+struct ScalarLanes {
+    using Float = float;
+    using Int = std::int32_t;
+    static constexpr int WIDTH = 1;
+
+    static Float load(const float *p) { return *p; }
+    static void store(float *p, Float v) { *p = v; }
+    static Float set(float v) { return v; }
+    static Float add(Float a, Float b) { return a + b; }
+    static Float sub(Float a, Float b) { return a - b; }
+    static Float mul(Float a, Float b) { return a * b; }
+    static Float div(Float a, Float b) { return a / b; }
+    static Float min(Float a, Float b) { return std::min(a, b); }
+    static Float max(Float a, Float b) { return std::max(a, b); }
+    static Float sqrt(Float a) { return std::sqrt(a); }
+    static Float greaterThan(Float a, Float b) { return a > b ? bitsToFloat(-1) : 0.0f; }
+    static Float lessThan(Float a, Float b) { return a < b ? bitsToFloat(-1) : 0.0f; }
+    static Float bitAnd(Float a, Float b) { return bitsToFloat(floatToBits(a) & floatToBits(b)); }
+    static Float select(Float mask, Float a, Float b) { return floatToBits(mask) ? a : b; }
+    static bool anySet(Float mask) { return floatToBits(mask) != 0; }
+    static Int floatToBits(Float a) {
+        Int bits;
+        std::memcpy(&bits, &a, sizeof(bits));
+        return bits;
+    }
+    static Float bitsToFloat(Int a) {
+        Float value;
+        std::memcpy(&value, &a, sizeof(value));
+        return value;
+    }
+    static Int setInt(std::int32_t v) { return v; }
+    static Int addInt(Int a, Int b) { return a + b; }
+    static Int subInt(Int a, Int b) { return a - b; }
+    static Int andInt(Int a, Int b) { return a & b; }
+    static Int orInt(Int a, Int b) { return a | b; }
+    static Int shiftRight(Int a, int n) {
+        return static_cast<Int>(static_cast<std::uint32_t>(a) >> n);
+    }
+    static Int shiftLeft(Int a, int n) {
+        return static_cast<Int>(static_cast<std::uint32_t>(a) << n);
+    }
+    static Float intToFloat(Int a) { return static_cast<Float>(a); }
+    static Int roundToInt(Float a) { return static_cast<Int>(std::nearbyint(a)); }
+};
+
+#if defined(__SSE2__) || defined(_M_X64)
+struct SseLanes {
+    using Float = __m128;
+    using Int = __m128i;
+    static constexpr int WIDTH = 4;
+
+    static Float load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, Float v) { _mm_storeu_ps(p, v); }
+    static Float set(float v) { return _mm_set1_ps(v); }
+    static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+    static Float div(Float a, Float b) { return _mm_div_ps(a, b); }
+    static Float min(Float a, Float b) { return _mm_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm_max_ps(a, b); }
+    static Float sqrt(Float a) { return _mm_sqrt_ps(a); }
+    static Float greaterThan(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+    static Float lessThan(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+    static Float bitAnd(Float a, Float b) { return _mm_and_ps(a, b); }
+    static Float select(Float mask, Float a, Float b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    static bool anySet(Float mask) { return _mm_movemask_ps(mask) != 0; }
+    static Int floatToBits(Float a) { return _mm_castps_si128(a); }
+    static Float bitsToFloat(Int a) { return _mm_castsi128_ps(a); }
+    static Int setInt(std::int32_t v) { return _mm_set1_epi32(v); }
+    static Int addInt(Int a, Int b) { return _mm_add_epi32(a, b); }
+    static Int subInt(Int a, Int b) { return _mm_sub_epi32(a, b); }
+    static Int andInt(Int a, Int b) { return _mm_and_si128(a, b); }
+    static Int orInt(Int a, Int b) { return _mm_or_si128(a, b); }
+    static Int shiftRight(Int a, int n) { return _mm_srli_epi32(a, n); }
+    static Int shiftLeft(Int a, int n) { return _mm_slli_epi32(a, n); }
+    static Float intToFloat(Int a) { return _mm_cvtepi32_ps(a); }
+    static Int roundToInt(Float a) { return _mm_cvtps_epi32(a); }
+};
+#endif
+
+#if defined(__AVX2__)
+struct Avx2Lanes {
+    using Float = __m256;
+    using Int = __m256i;
+    static constexpr int WIDTH = 8;
+
+    static Float load(const float *p) { return _mm256_loadu_ps(p); }
+    static void store(float *p, Float v) { _mm256_storeu_ps(p, v); }
+    static Float set(float v) { return _mm256_set1_ps(v); }
+    static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    static Float div(Float a, Float b) { return _mm256_div_ps(a, b); }
+    static Float min(Float a, Float b) { return _mm256_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm256_max_ps(a, b); }
+    static Float sqrt(Float a) { return _mm256_sqrt_ps(a); }
+    static Float greaterThan(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Float lessThan(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Float bitAnd(Float a, Float b) { return _mm256_and_ps(a, b); }
+    static Float select(Float mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+    static bool anySet(Float mask) { return _mm256_movemask_ps(mask) != 0; }
+    static Int floatToBits(Float a) { return _mm256_castps_si256(a); }
+    static Float bitsToFloat(Int a) { return _mm256_castsi256_ps(a); }
+    static Int setInt(std::int32_t v) { return _mm256_set1_epi32(v); }
+    static Int addInt(Int a, Int b) { return _mm256_add_epi32(a, b); }
+    static Int subInt(Int a, Int b) { return _mm256_sub_epi32(a, b); }
+    static Int andInt(Int a, Int b) { return _mm256_and_si256(a, b); }
+    static Int orInt(Int a, Int b) { return _mm256_or_si256(a, b); }
+    static Int shiftRight(Int a, int n) { return _mm256_srli_epi32(a, n); }
+    static Int shiftLeft(Int a, int n) { return _mm256_slli_epi32(a, n); }
+    static Float intToFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+    static Int roundToInt(Float a) { return _mm256_cvtps_epi32(a); }
+};
+using WideLanes = Avx2Lanes;
+#elif defined(__SSE2__) || defined(_M_X64)
+using WideLanes = SseLanes;
+#else
+using WideLanes = ScalarLanes;
+#endif
+
+}  // namespace TerrainKernel
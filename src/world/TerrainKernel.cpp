@@ -0,0 +1,134 @@
+#include "TerrainKernel.h"
+#include "world/SimdKernels.h"
+#include "world/SimdKernelsImpl.h"
+#include "world/WorldData.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace TerrainKernel {
+
+namespace {
+
+// Headroom for rounding differences between the chunk-wide bound and the per-cell maths.
+constexpr float UNIFORM_WATER_MARGIN = 1e-4f;
+
+}  // namespace
+
+ShapeParams makeShapeParams(const WorldGenParams &params) {
+    const float worldWidth =
+        static_cast<float>(params.worldDimensionsInChunks.x * params.chunkDimensionsInCells.x)
+        * params.cellSize;
+    const float worldHeight =
+        static_cast<float>(params.worldDimensionsInChunks.y * params.chunkDimensionsInCells.y)
+        * params.cellSize;
+
+    ShapeParams shape;
+    shape.centerX = worldWidth / 2.0f;
+    shape.centerY = worldHeight / 2.0f;
+    shape.maxDistance = std::min(worldWidth, worldHeight) / 2.5f;
+    shape.landThreshold = params.landThreshold;
+    shape.distortionStrength = params.coastlineDistortionStrength;
+    shape.elevationExponent = std::max(0.01f, params.elevation.elevationExponent);
+    shape.maxElevation = std::max(0.0f, params.elevation.maxElevation);
+
+    // Remapped noise lies in [0, 1], so each layer adds at most its weight when positive.
+    float totalWeight = 0.0f;
+    float positiveWeight = 0.0f;
+    for (const auto &layer : params.noiseLayers) {
+        totalWeight += layer.weight;
+        positiveWeight += std::max(0.0f, layer.weight);
+    }
+    shape.maxCombined = totalWeight > 0 ? positiveWeight / totalWeight : positiveWeight;
+    return shape;
+}
+
+bool isUniformWater(const ChunkLattice &lattice, const ShapeParams &shape) {
+    if (lattice.cellsX <= 0 || lattice.cellsY <= 0) {
+        return true;
+    }
+
+    // The lattice point nearest the continent centre has the largest falloff.
+    const float nearestX =
+        std::clamp(shape.centerX, lattice.worldX(0), lattice.worldX(lattice.cellsX - 1));
+    const float nearestY =
+        std::clamp(shape.centerY, lattice.worldY(0), lattice.worldY(lattice.cellsY - 1));
+    const float dx = shape.centerX - nearestX;
+    const float dy = shape.centerY - nearestY;
+    const float distance = std::sqrt(dx * dx + dy * dy);
+    const float maxFalloff = 1.0f - std::min(1.0f, distance / shape.maxDistance);
+
+    // Zero falloff zeroes the cell value whatever the noise, so skip the multiply.
+    const float maxValue = maxFalloff > 0.0f ? shape.maxCombined * maxFalloff : 0.0f;
+    const float minThreshold = shape.landThreshold - std::max(0.0f, shape.distortionStrength);
+    return maxValue + UNIFORM_WATER_MARGIN <= minThreshold;
+}
+
+void sampleNoiseField(const FastNoiseLite &noise, const ChunkLattice &lattice, float *out) {
+    thread_local std::vector<float> noiseX;
+    noiseX.resize(static_cast<std::size_t>(lattice.cellsX));
+    for (int x = 0; x < lattice.cellsX; ++x) {
+        noiseX[x] = lattice.worldX(x) / lattice.cellSize;
+    }
+
+    for (int y = 0; y < lattice.cellsY; ++y) {
+        const float noiseY = lattice.worldY(y) / lattice.cellSize;
+        float *row = out + static_cast<std::size_t>(y) * lattice.cellsX;
+        for (int x = 0; x < lattice.cellsX; ++x) {
+            row[x] = noise.GetNoise(noiseX[x], noiseY);
+        }
+    }
+}
+
+void noiseCoordinates(const ChunkLattice &lattice, float frequency, std::vector<float> &noiseX,
+                      std::vector<float> &noiseY) {
+    noiseX.resize(static_cast<std::size_t>(std::max(0, lattice.cellsX)));
+    for (int x = 0; x < lattice.cellsX; ++x) {
+        noiseX[x] = lattice.worldX(x) / lattice.cellSize * frequency;
+    }
+    noiseY.resize(static_cast<std::size_t>(std::max(0, lattice.cellsY)));
+    for (int y = 0; y < lattice.cellsY; ++y) {
+        noiseY[y] = lattice.worldY(y) / lattice.cellSize * frequency;
+    }
+}
+
+void combineFields(const ChunkLattice &lattice, const ShapeParams &shape,
+                   const float *const *layerFields, const float *layerWeights,
+                   std::size_t layerCount, const float *distortionField,
+                   TerrainType *outTerrain, float *outElevation) {
+    float totalWeight = 0.0f;
+    for (std::size_t layer = 0; layer < layerCount; ++layer) {
+        totalWeight += layerWeights[layer];
+    }
+
+    thread_local std::vector<float> worldX;
+    worldX.resize(static_cast<std::size_t>(lattice.cellsX));
+    for (int x = 0; x < lattice.cellsX; ++x) {
+        worldX[x] = lattice.worldX(x);
+    }
+
+    const SimdKernels::Table &kernels = SimdKernels::active();
+    SimdKernels::TerrainRow row;
+    row.worldX = worldX.data();
+    row.hasWeight = totalWeight > 0;
+    row.layerFields = layerFields;
+    row.layerWeights = layerWeights;
+    row.layerCount = layerCount;
+    row.totalWeight = totalWeight;
+    row.distortionField = distortionField;
+    row.outTerrain = outTerrain;
+    row.outElevation = outElevation;
+    for (int y = 0; y < lattice.cellsY; ++y) {
+        const float dy = shape.centerY - lattice.worldY(y);
+        row.dy2 = dy * dy;
+        row.rowOffset = y * lattice.cellsX;
+        kernels.combineTerrain(shape, row, 0, lattice.cellsX);
+    }
+}
+
+float approxPow(float base, float exponent) {
+    return SimdKernels::lanePow<ScalarLanes>(base, exponent);
+}
+
+}  // namespace TerrainKernel
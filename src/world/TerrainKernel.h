@@ -0,0 +1,79 @@
+#pragma once
+
+#include "FastNoiseLite.h"
+#include "world/TerrainType.h"
+#include <cstddef>
+#include <vector>
+
+struct WorldGenParams;
+
+// Batched terrain sampling for whole chunks. Each noise layer is evaluated over the
+// chunk lattice into a flat field first, then the per-cell arithmetic (falloff,
+// layer weighting, land threshold and elevation curve) runs over SIMD lanes.
+namespace TerrainKernel {
+
+// The cell lattice covered by one chunk. Cell (x, y) sits at global cell
+// (firstCellX + x * cellStep, firstCellY + y * cellStep).
+struct ChunkLattice {
+    int cellsX = 0;
+    int cellsY = 0;
+    int firstCellX = 0;
+    int firstCellY = 0;
+    int cellStep = 1;
+    float cellSize = 1.0f;
+
+    int cellCount() const noexcept { return cellsX * cellsY; }
+    float worldX(int x) const noexcept {
+        return static_cast<float>(firstCellX + x * cellStep) * cellSize;
+    }
+    float worldY(int y) const noexcept {
+        return static_cast<float>(firstCellY + y * cellStep) * cellSize;
+    }
+};
+
+// Continent-wide constants, resolved once per generation pass instead of per cell.
+struct ShapeParams {
+    float centerX = 0.0f;
+    float centerY = 0.0f;
+    float maxDistance = 1.0f;
+    float landThreshold = 0.0f;
+    float distortionStrength = 0.0f;
+    float elevationExponent = 1.0f;
+    float maxElevation = 0.0f;
+    // Largest value the weighted layer sum can reach before falloff, given [-1, 1] noise.
+    float maxCombined = 1.0f;
+};
+
+ShapeParams makeShapeParams(const WorldGenParams &params);
+
+// True when no cell of `lattice` can be land: the lattice lies wholly past the continent
+// falloff, or the noise bounds cannot reach the land threshold anywhere in it. Such a
+// lattice is all water at zero elevation, and no noise needs to be evaluated for it.
+bool isUniformWater(const ChunkLattice &lattice, const ShapeParams &shape);
+
+// Writes the raw [-1, 1] output of `noise` for every lattice cell into `out`.
+void sampleNoiseField(const FastNoiseLite &noise, const ChunkLattice &lattice, float *out);
+
+// Fills `noiseX` and `noiseY` with the noise-space coordinates of the lattice's columns and
+// rows: the same steps as sampleNoiseField, followed by GetNoise's scaling by `frequency`.
+// Specialized samplers start from these to match FastNoiseLite bit for bit.
+void noiseCoordinates(const ChunkLattice &lattice, float frequency, std::vector<float> &noiseX,
+                      std::vector<float> &noiseY);
+
+// Combines per-layer noise fields into terrain types and elevations. `layerFields`
+// holds `layerCount` pointers to lattice-sized fields; `distortionField` may be null
+// when coastline distortion is disabled.
+void combineFields(const ChunkLattice &lattice, const ShapeParams &shape,
+                   const float *const *layerFields, const float *layerWeights,
+                   std::size_t layerCount, const float *distortionField,
+                   TerrainType *outTerrain, float *outElevation);
+
+// Polynomial pow() used by the SIMD lanes. Valid for base in [0, 1] and positive
+// exponents; relative error stays below 1e-5 over that range.
+float approxPow(float base, float exponent);
+
+// Largest difference in normalized elevation (elevation / maxElevation) the batched
+// kernel may show against the scalar sampleTerrain path. Terrain types must match.
+constexpr float NORMALIZED_ELEVATION_TOLERANCE = 1e-4f;
+
+}  // namespace TerrainKernel
@@ -0,0 +1,112 @@
+#include "TerrainQueryService.h"
+#include "Constants.h"
+#include "components/WorldComponents.h"
+#include "systems/world/ChunkManagerSystem.h"
+#include "systems/world/WorldGenerationSystem.h"
+#include "world/WorldRaster.h"
+
+TerrainQueryService::TerrainQueryService(entt::registry &registry,
+                                         WorldGenerationSystem &worldGenSystem,
+                                         WorldRaster &worldRaster)
+    : _registry(registry), _worldGenSystem(worldGenSystem), _worldRaster(worldRaster) {}
+
+void TerrainQueryService::setChunkSource(const ChunkManagerSystem *chunkManager) {
+    _chunkManager = chunkManager;
+}
+
+TerrainQueryService::Sample TerrainQueryService::sampleAt(const sf::Vector2f &worldPosition) {
+    const Source source = acquireSource();
+    return sampleCell(source, static_cast<int>(std::floor(worldPosition.x / source.cellSize)),
+                      static_cast<int>(std::floor(worldPosition.y / source.cellSize)));
+}
+
+void TerrainQueryService::sampleBatch(const std::vector<sf::Vector2f> &worldPositions,
+                                      std::vector<Sample> &out) {
+    const Source source = acquireSource();
+    out.resize(worldPositions.size());
+    for (std::size_t i = 0; i < worldPositions.size(); ++i) {
+        out[i] = sampleCell(source,
+                            static_cast<int>(std::floor(worldPositions[i].x / source.cellSize)),
+                            static_cast<int>(std::floor(worldPositions[i].y / source.cellSize)));
+    }
+}
+
+float TerrainQueryService::getCellSize() {
+    return _worldGenSystem.getSnapshot()->params.cellSize;
+}
+
+TerrainQueryService::Source TerrainQueryService::acquireSource() {
+    Source source;
+    source.snapshot = _worldGenSystem.getSnapshot();
+    source.raster = _worldRaster.findReady(source.snapshot->generationId);
+
+    const WorldGenParams &params = source.snapshot->params;
+    source.chunkDimensionsInCells = params.chunkDimensionsInCells;
+    source.cellsX = params.worldDimensionsInChunks.x * params.chunkDimensionsInCells.x;
+    source.cellsY = params.worldDimensionsInChunks.y * params.chunkDimensionsInCells.y;
+    source.cellSize = params.cellSize;
+
+    if (_cacheGenerationId != source.snapshot->generationId) {
+        _fallbackCache.clear();
+        _cacheGenerationId = source.snapshot->generationId;
+    }
+    return source;
+}
+
+TerrainQueryService::Sample TerrainQueryService::sampleCell(const Source &source, int cellX,
+                                                            int cellY) {
+    if (cellX < 0 || cellY < 0 || cellX >= source.cellsX || cellY >= source.cellsY) {
+        return {};
+    }
+
+    const std::uint64_t cellIndex =
+        static_cast<std::uint64_t>(cellY) * static_cast<std::uint64_t>(source.cellsX) + cellX;
+    if (source.raster) {
+        return {source.raster->terrain[cellIndex], source.raster->elevations[cellIndex]};
+    }
+
+    Sample sample;
+    if (sampleLoadedChunk(source, cellX, cellY, sample)) {
+        return sample;
+    }
+
+    auto cached = _fallbackCache.find(cellIndex);
+    if (cached != _fallbackCache.end()) {
+        return cached->second;
+    }
+    // Chunk lattices sample each cell at its corner, so the fallback does the same.
+    const auto terrain = WorldGenerationSystem::sampleTerrain(
+        *source.snapshot, static_cast<float>(cellX) * source.cellSize,
+        static_cast<float>(cellY) * source.cellSize);
+    sample = {terrain.terrainType, terrain.elevation};
+    if (_fallbackCache.size() >= Constants::TERRAIN_QUERY_CACHE_CELLS) {
+        _fallbackCache.clear();
+    }
+    _fallbackCache.emplace(cellIndex, sample);
+    return sample;
+}
+
+bool TerrainQueryService::sampleLoadedChunk(const Source &source, int cellX, int cellY,
+                                            Sample &out) const {
+    if (!_chunkManager) {
+        return false;
+    }
+    const int chunkCellsX = source.chunkDimensionsInCells.x;
+    const int chunkCellsY = source.chunkDimensionsInCells.y;
+    const ChunkKey key{{cellX / chunkCellsX, cellY / chunkCellsY}, 0};
+    const entt::entity entity = _chunkManager->findActiveChunk(key);
+    if (entity == entt::null) {
+        return false;
+    }
+
+    const ChunkCellsView cells{_registry.get<ChunkTerrainComponent>(entity).cells,
+                               _registry.get<ChunkElevationComponent>(entity).elevations,
+                               chunkCellsX, chunkCellsY};
+    const int localX = cellX % chunkCellsX;
+    const int localY = cellY % chunkCellsY;
+    if (!cells.contains(localX, localY)) {
+        return false;
+    }
+    out = {cells.terrainAt(localX, localY), cells.elevationAt(localX, localY)};
+    return true;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "world/TerrainType.h"
+#include <SFML/System/Vector2.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <entt/entt.hpp>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class ChunkManagerSystem;
+class WorldGenerationSystem;
+class WorldRaster;
+struct TerrainRaster;
+struct WorldGenSnapshot;
+
+// Answers terrain and elevation queries for level-0 cells. Each cell is read from the world
+// raster when it is built, otherwise from a loaded full-resolution chunk, and only falls
+// back to evaluating noise (cached per cell) when neither has it. Main thread only.
+class TerrainQueryService {
+public:
+    struct Sample {
+        TerrainType terrain = TerrainType::WATER;
+        float elevation = 0.0f;
+    };
+
+    TerrainQueryService(entt::registry &registry, WorldGenerationSystem &worldGenSystem,
+                        WorldRaster &worldRaster);
+
+    // Loaded chunks are only consulted once a source is set.
+    void setChunkSource(const ChunkManagerSystem *chunkManager);
+
+    // The cell containing `worldPosition`. Cells outside the world are water.
+    Sample sampleAt(const sf::Vector2f &worldPosition);
+    void sampleBatch(const std::vector<sf::Vector2f> &worldPositions, std::vector<Sample> &out);
+
+    // Calls `visitor(cell, sample)` for every cell the segment passes through, in order from
+    // `from`, until it returns false. Consecutive cells always share an edge.
+    template <typename Visitor>
+    void forEachCellOnSegment(const sf::Vector2f &from, const sf::Vector2f &to,
+                              Visitor &&visitor);
+
+    float getCellSize();
+
+private:
+    struct Source {
+        std::shared_ptr<const WorldGenSnapshot> snapshot;
+        std::shared_ptr<const TerrainRaster> raster;
+        int cellsX = 0;
+        int cellsY = 0;
+        sf::Vector2i chunkDimensionsInCells;
+        float cellSize = 1.0f;
+    };
+
+    Source acquireSource();
+    Sample sampleCell(const Source &source, int cellX, int cellY);
+    bool sampleLoadedChunk(const Source &source, int cellX, int cellY, Sample &out) const;
+
+    entt::registry &_registry;
+    WorldGenerationSystem &_worldGenSystem;
+    WorldRaster &_worldRaster;
+    const ChunkManagerSystem *_chunkManager = nullptr;
+
+    // Noise fallbacks for the current snapshot, keyed by cell index.
+    std::size_t _cacheGenerationId = 0;
+    std::unordered_map<std::uint64_t, Sample> _fallbackCache;
+};
+
+template <typename Visitor>
+void TerrainQueryService::forEachCellOnSegment(const sf::Vector2f &from, const sf::Vector2f &to,
+                                               Visitor &&visitor) {
+    const Source source = acquireSource();
+    // Doubles keep the boundary crossings exact enough that long segments passing close to
+    // a cell corner still step into the cell the segment actually enters.
+    const double startX = static_cast<double>(from.x) / source.cellSize;
+    const double startY = static_cast<double>(from.y) / source.cellSize;
+    const double deltaX = static_cast<double>(to.x) / source.cellSize - startX;
+    const double deltaY = static_cast<double>(to.y) / source.cellSize - startY;
+
+    sf::Vector2i cell = {static_cast<int>(std::floor(startX)),
+                         static_cast<int>(std::floor(startY))};
+    const sf::Vector2i endCell = {static_cast<int>(std::floor(startX + deltaX)),
+                                  static_cast<int>(std::floor(startY + deltaY))};
+    const int stepX = deltaX > 0.0 ? 1 : -1;
+    const int stepY = deltaY > 0.0 ? 1 : -1;
+
+    // Amanatides-Woo traversal: the segment parameter at the next cell boundary on each
+    // axis decides which neighbour comes next. It is recomputed from the boundary rather
+    // than accumulated, so error does not build up along the segment.
+    auto nextCrossing = [](int cellIndex, int step, double start, double delta) {
+        if (delta == 0.0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        const double boundary = static_cast<double>(step > 0 ? cellIndex + 1 : cellIndex);
+        return (boundary - start) / delta;
+    };
+
+    // Steps are counted rather than derived from the crossings, so rounding can never walk
+    // past the end cell.
+    const int steps = std::abs(endCell.x - cell.x) + std::abs(endCell.y - cell.y);
+    for (int i = 0;; ++i) {
+        if (!visitor(cell, sampleCell(source, cell.x, cell.y)) || i == steps) {
+            return;
+        }
+        const bool stepAlongX =
+            cell.y == endCell.y
+            || (cell.x != endCell.x
+                && nextCrossing(cell.x, stepX, startX, deltaX)
+                       < nextCrossing(cell.y, stepY, startY, deltaY));
+        if (stepAlongX) {
+            cell.x += stepX;
+        } else {
+            cell.y += stepY;
+        }
+    }
+}
@@ -2,7 +2,10 @@
 
 #include "FastNoiseLite.h"
 #include "TerrainType.h"
+#include "PackedTerrain.h"
 #include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 struct Point {
@@ -26,22 +29,51 @@ struct ElevationParams {
     float elevationExponent = 1.0f;
 };
 
+// Low-frequency octaves barely change across a chunk, so they may be evaluated on a coarse
+// lattice and bicubically upsampled, leaving only the higher octaves to run at every cell.
+struct OctaveSplitParams {
+    bool enabled = false;
+    // Octaves below this frequency, in the units of NoiseLayer::frequency, may be upsampled.
+    float cutoffFrequency = 0.05f;
+    // Largest estimated difference upsampling may introduce into a layer's [-1, 1] noise.
+    float maxError = 0.001f;
+};
+
 struct WorldGenParams {
     std::vector<NoiseLayer> noiseLayers;
     float landThreshold = 0.35f;
     float coastlineDistortionStrength = 0.0f;
     std::vector<Point> continentShape;
     ElevationParams elevation;
+    OctaveSplitParams octaveSplit;
 
     sf::Vector2i worldDimensionsInChunks = {100, 100};
     sf::Vector2i chunkDimensionsInCells = {32, 32};
     float cellSize = 16.0f;
 };
 
-struct SwapWorldStateEvent {};
+// Raw [-1, 1] noise for one generator over a chunk lattice. `signature` identifies the
+// generator settings that produced it, so the field can be reused while they are unchanged.
+struct NoiseField {
+    std::uint64_t signature = 0;
+    std::vector<float> values;
+};
+
+// The noise inputs a chunk was combined from. Fields are immutable once built and shared
+// between successive generations of the same chunk.
+struct ChunkNoiseFields {
+    std::vector<std::shared_ptr<const NoiseField>> layers;
+    std::shared_ptr<const NoiseField> distortion;
+};
 
 struct GeneratedChunkData {
     sf::Vector2i chunkGridPosition;
-    std::vector<TerrainType> cells;
-    std::vector<float> elevations;
+    // Level 0 is full resolution; level N samples every 2^N-th cell over a chunk that
+    // covers 2^N x 2^N level-0 chunks.
+    int lodLevel = 0;
+    PackedTerrainCells cells;
+    QuantizedElevations elevations;
+    // Null when the chunk came from a save, the disk cache or the raster, or was open ocean
+    // and needed no noise.
+    std::shared_ptr<const ChunkNoiseFields> noiseFields;
 };
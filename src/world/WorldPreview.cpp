@@ -0,0 +1,158 @@
+#include "WorldPreview.h"
+#include "Constants.h"
+#include "Logger.h"
+#include "core/ThreadPool.h"
+#include "systems/world/WorldGenerationSystem.h"
+#include "world/TerrainKernel.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+struct WorldPreview::Build {
+    std::uint64_t requestId = 0;
+    std::shared_ptr<const WorldGenSnapshot> snapshot;
+    std::shared_ptr<WorldPreviewImage> image;
+    TerrainKernel::ShapeParams shape;
+    int tilesX = 0;
+    int tileCount = 0;
+    std::atomic<int> nextTile{0};
+    std::atomic<int> finishedTiles{0};
+    std::chrono::steady_clock::time_point start;
+};
+
+WorldPreview::WorldPreview(ThreadPool &threadPool)
+    : _threadPool(threadPool), _shared(std::make_shared<Shared>()) {}
+
+WorldPreview::~WorldPreview() {
+    // Queued workers see a request that can never match and return without generating.
+    _shared->currentRequest.store(0, std::memory_order_relaxed);
+}
+
+void WorldPreview::request(std::shared_ptr<const WorldGenSnapshot> snapshot) {
+    const WorldGenParams &params = snapshot->params;
+    const int worldWidth =
+        std::max(1, params.worldDimensionsInChunks.x * params.chunkDimensionsInCells.x);
+    const int worldHeight =
+        std::max(1, params.worldDimensionsInChunks.y * params.chunkDimensionsInCells.y);
+    const int previewSize = Constants::WORLD_PREVIEW_SIZE;
+    const int cellStep = (std::max(worldWidth, worldHeight) + previewSize - 1) / previewSize;
+
+    auto build = std::make_shared<Build>();
+    build->requestId = ++_lastRequest;
+    build->snapshot = std::move(snapshot);
+    build->shape = TerrainKernel::makeShapeParams(build->snapshot->params);
+    build->image = std::make_shared<WorldPreviewImage>();
+    WorldPreviewImage &image = *build->image;
+    image.requestId = build->requestId;
+    image.cellStep = cellStep;
+    image.width = (worldWidth + cellStep - 1) / cellStep;
+    image.height = (worldHeight + cellStep - 1) / cellStep;
+    const std::size_t sampleCount = static_cast<std::size_t>(image.width) * image.height;
+    image.terrain.assign(sampleCount, TerrainType::WATER);
+    image.normalizedElevations.assign(sampleCount, 0.0f);
+
+    const int tileCells = Constants::WORLD_PREVIEW_TILE_CELLS;
+    build->tilesX = (image.width + tileCells - 1) / tileCells;
+    build->tileCount = build->tilesX * ((image.height + tileCells - 1) / tileCells);
+    build->start = std::chrono::steady_clock::now();
+
+    _shared->currentRequest.store(build->requestId, std::memory_order_relaxed);
+    const int workerCount =
+        std::min(build->tileCount,
+                 static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+    for (int i = 0; i < workerCount; ++i) {
+        _threadPool.post(TaskPriority::Interactive,
+                         [shared = _shared, build]() { generateTiles(*shared, *build); });
+    }
+}
+
+std::shared_ptr<const WorldPreviewImage> WorldPreview::latest() const {
+    std::lock_guard<std::mutex> lock(_shared->mutex);
+    return _shared->latest;
+}
+
+bool WorldPreview::isPending() const {
+    std::lock_guard<std::mutex> lock(_shared->mutex);
+    return _lastRequest != 0 && (!_shared->latest || _shared->latest->requestId != _lastRequest);
+}
+
+void WorldPreview::generateTiles(Shared &shared, Build &build) {
+    while (shared.currentRequest.load(std::memory_order_relaxed) == build.requestId) {
+        const int tile = build.nextTile.fetch_add(1, std::memory_order_relaxed);
+        if (tile >= build.tileCount) {
+            return;
+        }
+        generateTile(build, tile);
+        if (build.finishedTiles.fetch_add(1, std::memory_order_acq_rel) + 1 != build.tileCount) {
+            continue;
+        }
+
+        build.image->milliseconds = std::chrono::duration<double, std::milli>(
+                                        std::chrono::steady_clock::now() - build.start)
+                                        .count();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (shared.currentRequest.load(std::memory_order_relaxed) == build.requestId) {
+            shared.latest = build.image;
+            LOG_DEBUG("WorldPreview", "Generated %d x %d preview in %.1f ms.", build.image->width,
+                      build.image->height, build.image->milliseconds);
+        }
+        return;
+    }
+}
+
+void WorldPreview::generateTile(Build &build, int tileIndex) {
+    const WorldGenSnapshot &snapshot = *build.snapshot;
+    const WorldGenParams &params = snapshot.params;
+    WorldPreviewImage &image = *build.image;
+    const int tileCells = Constants::WORLD_PREVIEW_TILE_CELLS;
+    const int firstX = (tileIndex % build.tilesX) * tileCells;
+    const int firstY = (tileIndex / build.tilesX) * tileCells;
+
+    TerrainKernel::ChunkLattice lattice;
+    lattice.cellsX = std::min(tileCells, image.width - firstX);
+    lattice.cellsY = std::min(tileCells, image.height - firstY);
+    lattice.firstCellX = firstX * image.cellStep;
+    lattice.firstCellY = firstY * image.cellStep;
+    lattice.cellStep = image.cellStep;
+    lattice.cellSize = params.cellSize;
+    // The image starts out as water at sea level.
+    if (TerrainKernel::isUniformWater(lattice, build.shape)) {
+        return;
+    }
+
+    const std::size_t cellCount = static_cast<std::size_t>(lattice.cellCount());
+    const std::size_t layerCount = snapshot.noiseGenerators.size();
+    std::vector<std::vector<float>> fields(layerCount, std::vector<float>(cellCount));
+    std::vector<const float *> layerFields(layerCount);
+    std::vector<float> layerWeights(layerCount);
+    for (std::size_t i = 0; i < layerCount; ++i) {
+        snapshot.layerSamplers[i](snapshot.noiseGenerators[i], params.noiseLayers[i],
+                                  params.octaveSplit, lattice, fields[i].data());
+        layerFields[i] = fields[i].data();
+        layerWeights[i] = params.noiseLayers[i].weight;
+    }
+
+    std::vector<float> distortion;
+    if (params.coastlineDistortionStrength > 0.0f) {
+        distortion.resize(cellCount);
+        TerrainKernel::sampleNoiseField(snapshot.coastlineDistortion, lattice, distortion.data());
+    }
+
+    std::vector<TerrainType> terrain(cellCount);
+    std::vector<float> elevations(cellCount);
+    TerrainKernel::combineFields(lattice, build.shape, layerFields.data(), layerWeights.data(),
+                                 layerCount, distortion.empty() ? nullptr : distortion.data(),
+                                 terrain.data(), elevations.data());
+
+    // Tiles never overlap, so they write the image without synchronisation.
+    const float maxElevation = std::max(0.0001f, params.elevation.maxElevation);
+    for (int y = 0; y < lattice.cellsY; ++y) {
+        const std::size_t rowStart = static_cast<std::size_t>(firstY + y) * image.width + firstX;
+        const std::size_t latticeRow = static_cast<std::size_t>(y) * lattice.cellsX;
+        for (int x = 0; x < lattice.cellsX; ++x) {
+            image.terrain[rowStart + x] = terrain[latticeRow + x];
+            image.normalizedElevations[rowStart + x] =
+                std::clamp(elevations[latticeRow + x] / maxElevation, 0.0f, 1.0f);
+        }
+    }
+}
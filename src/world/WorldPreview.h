@@ -0,0 +1,60 @@
+#pragma once
+
+#include "world/TerrainType.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct WorldGenSnapshot;
+class ThreadPool;
+
+// A downsampled image of the whole world: one sample every `cellStep` level-0 cells.
+struct WorldPreviewImage {
+    std::uint64_t requestId = 0;
+    int width = 0;
+    int height = 0;
+    int cellStep = 1;
+    // Row-major, `width` samples per row. Elevations are normalized to [0, 1].
+    std::vector<TerrainType> terrain;
+    std::vector<float> normalizedElevations;
+    double milliseconds = 0.0;
+};
+
+// Generates whole-world previews on the thread pool for tuning generation settings without
+// regenerating any chunks. Each request supersedes the previous one: workers still on an
+// older request stop at their next tile, and only the newest request is ever published.
+class WorldPreview {
+public:
+    explicit WorldPreview(ThreadPool &threadPool);
+    ~WorldPreview();
+
+    WorldPreview(const WorldPreview &) = delete;
+    WorldPreview &operator=(const WorldPreview &) = delete;
+
+    // Starts a preview of `snapshot`, abandoning any preview still in progress.
+    void request(std::shared_ptr<const WorldGenSnapshot> snapshot);
+
+    // The most recently completed preview, or null before the first one completes.
+    std::shared_ptr<const WorldPreviewImage> latest() const;
+
+    // True while the newest request has not completed.
+    bool isPending() const;
+
+private:
+    struct Shared {
+        std::atomic<std::uint64_t> currentRequest{0};
+        mutable std::mutex mutex;
+        std::shared_ptr<const WorldPreviewImage> latest;
+    };
+    struct Build;
+
+    static void generateTiles(Shared &shared, Build &build);
+    static void generateTile(Build &build, int tileIndex);
+
+    ThreadPool &_threadPool;
+    // Shared with queued workers, which may outlive this object.
+    std::shared_ptr<Shared> _shared;
+    std::uint64_t _lastRequest = 0;
+};
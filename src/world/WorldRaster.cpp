@@ -0,0 +1,241 @@
+#include "WorldRaster.h"
+#include "Constants.h"
+#include "Logger.h"
+#include "core/ThreadPool.h"
+#include "systems/world/WorldGenerationSystem.h"
+#include "world/TerrainKernel.h"
+#include <algorithm>
+#include <chrono>
+
+void TerrainRaster::copyChunk(const sf::Vector2i &chunkDimensionsInCells,
+                              GeneratedChunkData &chunkData) const {
+    const int cellsX = chunkDimensionsInCells.x;
+    const int cellsY = chunkDimensionsInCells.y;
+    const int step = 1 << chunkData.lodLevel;
+    const int firstCellX = chunkData.chunkGridPosition.x * cellsX * step;
+    const int firstCellY = chunkData.chunkGridPosition.y * cellsY * step;
+
+    const std::size_t cellCount = static_cast<std::size_t>(cellsX) * cellsY;
+    chunkData.cells.assign(cellCount, TerrainType::WATER);
+    chunkData.elevations.assign(cellCount, elevations.getMaxElevation());
+
+    for (int y = 0; y < cellsY; ++y) {
+        const int rasterY = firstCellY + y * step;
+        if (rasterY < 0 || rasterY >= height) {
+            continue;
+        }
+        const std::size_t rowOffset = static_cast<std::size_t>(rasterY) * width;
+        for (int x = 0; x < cellsX; ++x) {
+            const int rasterX = firstCellX + x * step;
+            if (rasterX < 0 || rasterX >= width) {
+                continue;
+            }
+            const std::size_t cellIndex = static_cast<std::size_t>(y) * cellsX + x;
+            chunkData.cells.set(cellIndex, terrain[rowOffset + rasterX]);
+            chunkData.elevations.set(cellIndex, elevations[rowOffset + rasterX]);
+        }
+    }
+    chunkData.cells.compact();
+    chunkData.elevations.compact();
+}
+
+WorldRaster::WorldRaster(ThreadPool &threadPool) : _threadPool(threadPool) {}
+
+std::shared_ptr<const TerrainRaster>
+WorldRaster::acquire(const std::shared_ptr<const WorldGenSnapshot> &snapshot) {
+    std::shared_ptr<Build> build;
+    bool started = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_raster && _raster->generationId == snapshot->generationId) {
+            return _raster;
+        }
+        if (_build && _build->raster->generationId == snapshot->generationId) {
+            build = _build;
+        } else {
+            if (_build) {
+                _build->cancel.cancel();
+            }
+            build = startBuild(snapshot);
+            _build = build;
+            started = true;
+        }
+    }
+
+    if (!started) {
+        return finishBuild(build);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    // The caller works on bands too, so it only ever waits on bands already in progress.
+    // Helpers run on the compute workers, one of which is usually the caller itself.
+    const int helperCount =
+        std::min(build->bandCount, static_cast<int>(_threadPool.size()) - 1);
+    for (int i = 0; i < helperCount; ++i) {
+        _threadPool.post(TaskPriority::Background, [build]() { generateBands(*build); });
+    }
+    auto raster = finishBuild(build);
+    if (!raster) {
+        LOG_DEBUG("WorldRaster", "Raster build for generation %zu was superseded.",
+                  snapshot->generationId);
+        return nullptr;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    LOG_INFO("WorldRaster", "Generated %d x %d cell raster in %d bands in %lld ms.",
+             raster->width, raster->height, build->bandCount, static_cast<long long>(elapsed));
+    return raster;
+}
+
+std::shared_ptr<const TerrainRaster> WorldRaster::findReady(std::size_t generationId) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_raster && _raster->generationId == generationId) {
+        return _raster;
+    }
+    return nullptr;
+}
+
+void WorldRaster::cancelBuildsBefore(std::size_t generationId) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_build && _build->raster->generationId < generationId) {
+        _build->cancel.cancel();
+    }
+}
+
+std::shared_ptr<WorldRaster::Build>
+WorldRaster::startBuild(const std::shared_ptr<const WorldGenSnapshot> &snapshot) {
+    const WorldGenParams &params = snapshot->params;
+    auto build = std::make_shared<Build>();
+    build->snapshot = snapshot;
+    build->raster = std::make_shared<TerrainRaster>();
+    build->cancel = CancellationToken::create();
+
+    TerrainRaster &raster = *build->raster;
+    raster.generationId = snapshot->generationId;
+    raster.width = std::max(0, params.worldDimensionsInChunks.x * params.chunkDimensionsInCells.x);
+    raster.height =
+        std::max(0, params.worldDimensionsInChunks.y * params.chunkDimensionsInCells.y);
+    const std::size_t cellCount = static_cast<std::size_t>(raster.width) * raster.height;
+    raster.terrain.assign(cellCount, TerrainType::WATER);
+    raster.elevations.assign(cellCount, params.elevation.maxElevation);
+    raster.terrain.expand();
+    raster.elevations.expand();
+
+    const int bandRows = Constants::WORLD_RASTER_BAND_ROWS;
+    build->bandCount = (raster.height + bandRows - 1) / bandRows;
+    return build;
+}
+
+std::shared_ptr<const TerrainRaster>
+WorldRaster::finishBuild(const std::shared_ptr<Build> &build) {
+    generateBands(*build);
+    {
+        std::unique_lock<std::mutex> lock(build->mutex);
+        build->finished.wait(lock, [&build]() {
+            return build->finishedBands.load(std::memory_order_acquire) == build->bandCount;
+        });
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_build == build) {
+        _build.reset();
+    }
+    // Cancelled bands were skipped, so the raster is incomplete.
+    if (build->cancel.isCancelled()) {
+        return nullptr;
+    }
+    // A newer build may have been published while this one was finishing.
+    if (!_raster || _raster->generationId < build->raster->generationId) {
+        _raster = build->raster;
+    }
+    return build->raster;
+}
+
+void WorldRaster::generateBands(Build &build) {
+    for (int band = build.nextBand.fetch_add(1, std::memory_order_relaxed);
+         band < build.bandCount; band = build.nextBand.fetch_add(1, std::memory_order_relaxed)) {
+        generateBand(build, band);
+        if (build.finishedBands.fetch_add(1, std::memory_order_acq_rel) + 1 == build.bandCount) {
+            std::lock_guard<std::mutex> lock(build.mutex);
+            build.finished.notify_all();
+        }
+    }
+}
+
+void WorldRaster::generateBand(Build &build, int bandIndex) {
+    static_assert(Constants::WORLD_RASTER_BAND_ROWS % PackedTerrainCells::CELLS_PER_BYTE == 0,
+                  "Raster bands must start on a packed terrain byte.");
+    if (build.cancel.isCancelled()) {
+        return;
+    }
+    const WorldGenSnapshot &snapshot = *build.snapshot;
+    const WorldGenParams &params = snapshot.params;
+    TerrainRaster &raster = *build.raster;
+    const int bandRows = Constants::WORLD_RASTER_BAND_ROWS;
+
+    TerrainKernel::ChunkLattice lattice;
+    lattice.firstCellY = bandIndex * bandRows;
+    lattice.cellsY = std::min(bandRows, raster.height - lattice.firstCellY);
+    lattice.cellSize = params.cellSize;
+    const TerrainKernel::ShapeParams shape = TerrainKernel::makeShapeParams(params);
+
+    // Only columns between the first and last chunk-wide span that can hold land are
+    // evaluated; the rest of the band keeps the water it was initialised with.
+    const int spanCells = std::max(1, params.chunkDimensionsInCells.x);
+    int firstColumn = raster.width;
+    int endColumn = 0;
+    for (int column = 0; column < raster.width; column += spanCells) {
+        lattice.firstCellX = column;
+        lattice.cellsX = std::min(spanCells, raster.width - column);
+        if (!TerrainKernel::isUniformWater(lattice, shape)) {
+            firstColumn = std::min(firstColumn, column);
+            endColumn = column + lattice.cellsX;
+        }
+    }
+    if (firstColumn >= endColumn) {
+        return;
+    }
+    lattice.firstCellX = firstColumn;
+    lattice.cellsX = endColumn - firstColumn;
+    const std::size_t cellCount = static_cast<std::size_t>(lattice.cellCount());
+
+    const std::size_t layerCount = snapshot.noiseGenerators.size();
+    std::vector<std::vector<float>> fields(layerCount, std::vector<float>(cellCount));
+    std::vector<const float *> layerFields(layerCount);
+    std::vector<float> layerWeights(layerCount);
+    for (std::size_t i = 0; i < layerCount; ++i) {
+        if (build.cancel.isCancelled()) {
+            return;
+        }
+        snapshot.layerSamplers[i](snapshot.noiseGenerators[i], params.noiseLayers[i],
+                                  params.octaveSplit, lattice, fields[i].data());
+        layerFields[i] = fields[i].data();
+        layerWeights[i] = params.noiseLayers[i].weight;
+    }
+
+    std::vector<float> distortion;
+    if (params.coastlineDistortionStrength > 0.0f) {
+        distortion.resize(cellCount);
+        TerrainKernel::sampleNoiseField(snapshot.coastlineDistortion, lattice, distortion.data());
+    }
+
+    std::vector<TerrainType> terrain(cellCount);
+    std::vector<float> elevations(cellCount);
+    TerrainKernel::combineFields(lattice, shape, layerFields.data(), layerWeights.data(),
+                                 layerCount, distortion.empty() ? nullptr : distortion.data(),
+                                 terrain.data(), elevations.data());
+
+    // Bands cover whole rows and start on a packed byte, so no two threads write the same
+    // byte and the band needs no synchronisation.
+    for (int y = 0; y < lattice.cellsY; ++y) {
+        const std::size_t rowStart =
+            static_cast<std::size_t>(lattice.firstCellY + y) * raster.width + firstColumn;
+        const std::size_t latticeRow = static_cast<std::size_t>(y) * lattice.cellsX;
+        for (int x = 0; x < lattice.cellsX; ++x) {
+            raster.terrain.set(rowStart + x, terrain[latticeRow + x]);
+            raster.elevations.set(rowStart + x, elevations[latticeRow + x]);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "core/CancellationToken.h"
+#include "world/TerrainType.h"
+#include "world/WorldData.h"
+#include <SFML/System/Vector2.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct WorldGenSnapshot;
+class ThreadPool;
+
+// Terrain and elevation for every level-0 cell of the world, generated from one snapshot.
+// Immutable once published.
+struct TerrainRaster {
+    std::size_t generationId = 0;
+    int width = 0;
+    int height = 0;
+    // Row-major, `width` cells per row.
+    PackedTerrainCells terrain;
+    QuantizedElevations elevations;
+
+    // Fills `chunkData` with the chunk's cells. A level-N chunk takes every 2^N-th cell;
+    // cells past the world edge are water.
+    void copyChunk(const sf::Vector2i &chunkDimensionsInCells, GeneratedChunkData &chunkData) const;
+};
+
+// Builds the whole-world raster once per snapshot, in parallel bands of rows, and shares it
+// between chunk streaming and city placement. Safe to call from any thread, including pool
+// workers: a caller that has to wait for a build works on its remaining bands instead of
+// blocking.
+class WorldRaster {
+public:
+    explicit WorldRaster(ThreadPool &threadPool);
+
+    // Returns the raster for `snapshot`, building it first if it does not exist yet. Null if
+    // the build was cancelled because a newer snapshot superseded it.
+    std::shared_ptr<const TerrainRaster>
+    acquire(const std::shared_ptr<const WorldGenSnapshot> &snapshot);
+
+    // Returns the raster for `generationId` only if it is complete; never waits.
+    std::shared_ptr<const TerrainRaster> findReady(std::size_t generationId) const;
+
+    // Cancels a build in progress for a snapshot older than `generationId`. Its workers stop
+    // at their next band or layer, and the partial raster is never published.
+    void cancelBuildsBefore(std::size_t generationId);
+
+private:
+    struct Build {
+        std::shared_ptr<const WorldGenSnapshot> snapshot;
+        std::shared_ptr<TerrainRaster> raster;
+        CancellationToken cancel;
+        int bandCount = 0;
+        std::atomic<int> nextBand{0};
+        std::atomic<int> finishedBands{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    std::shared_ptr<Build> startBuild(const std::shared_ptr<const WorldGenSnapshot> &snapshot);
+    std::shared_ptr<const TerrainRaster> finishBuild(const std::shared_ptr<Build> &build);
+    static void generateBands(Build &build);
+    static void generateBand(Build &build, int bandIndex);
+
+    ThreadPool &_threadPool;
+    mutable std::mutex _mutex;
+    std::shared_ptr<const TerrainRaster> _raster;
+    std::shared_ptr<Build> _build;
+};